@@ -0,0 +1,28 @@
+// Host build: GPIO levels are kept in memory
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include "pico/types.h"
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+
+enum gpio_function
+{
+    GPIO_FUNC_SPI,
+    GPIO_FUNC_UART,
+    GPIO_FUNC_I2C,
+    GPIO_FUNC_PWM,
+    GPIO_FUNC_SIO,
+    GPIO_FUNC_PIO0,
+    GPIO_FUNC_PIO1
+};
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_put(uint gpio, bool value);
+bool gpio_get(uint gpio);
+void gpio_pull_up(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+
+#endif // HOST_HARDWARE_GPIO_H
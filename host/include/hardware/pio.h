@@ -0,0 +1,40 @@
+// Host build: TX FIFO words are decoded as st7735.pio frames
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "pico/types.h"
+
+typedef struct
+{
+    volatile uint32_t ctrl, fstat, fdebug, flevel;
+    volatile uint32_t txf[4];
+    volatile uint32_t rxf[4];
+} pio_hw_t;
+
+typedef pio_hw_t *PIO;
+extern PIO pio0;
+extern PIO pio1;
+
+typedef struct
+{
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+typedef struct
+{
+    uint32_t clkdiv;
+} pio_sm_config;
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm);
+uint8_t pio_sm_get_pc(PIO pio, uint sm);
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled);
+void pio_sm_unclaim(PIO pio, uint sm);
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset);
+
+#endif // HOST_HARDWARE_PIO_H
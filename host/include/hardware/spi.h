@@ -0,0 +1,46 @@
+// Host build: SPI writes go straight to the simulated panel
+#ifndef HOST_HARDWARE_SPI_H
+#define HOST_HARDWARE_SPI_H
+
+#include "pico/types.h"
+
+typedef struct
+{
+    volatile uint32_t cr0, cr1, dr, sr, cpsr, imsc, ris, mis, icr, dmacr;
+} spi_hw_t;
+
+typedef struct spi_inst spi_inst_t;
+extern spi_inst_t *spi0;
+extern spi_inst_t *spi1;
+
+#define SPI_SSPICR_RORIC_BITS 0x1u
+
+typedef enum
+{
+    SPI_CPOL_0,
+    SPI_CPOL_1
+} spi_cpol_t;
+
+typedef enum
+{
+    SPI_CPHA_0,
+    SPI_CPHA_1
+} spi_cpha_t;
+
+typedef enum
+{
+    SPI_LSB_FIRST,
+    SPI_MSB_FIRST
+} spi_order_t;
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+uint spi_get_baudrate(const spi_inst_t *spi);
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len);
+int spi_write16_blocking(spi_inst_t *spi, const uint16_t *src, size_t len);
+bool spi_is_busy(const spi_inst_t *spi);
+bool spi_is_readable(const spi_inst_t *spi);
+spi_hw_t *spi_get_hw(spi_inst_t *spi);
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx);
+
+#endif // HOST_HARDWARE_SPI_H
@@ -0,0 +1,7 @@
+// Host build: barriers map to the compiler's full fence
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+#endif // HOST_HARDWARE_SYNC_H
@@ -0,0 +1,11 @@
+// Host build: core 1 is a thread, the inter-core FIFO a 4-entry queue
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+#include "pico/types.h"
+
+void multicore_launch_core1(void (*entry)(void));
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+
+#endif // HOST_PICO_MULTICORE_H
@@ -0,0 +1,23 @@
+// Host build: the parts of pico/stdlib.h the game and drivers use
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include "hardware/gpio.h"
+#include "pico/time.h"
+#include "pico/types.h"
+#include <sched.h>
+
+#define __dmb() __sync_synchronize()
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+// Spin-waits give the other "core" the CPU, which on a host with fewer
+// cores than threads would otherwise only get it at the next time slice
+static inline void tight_loop_contents(void)
+{
+    sched_yield();
+}
+
+void stdio_init_all(void);
+uint get_core_num(void);
+
+#endif // HOST_PICO_STDLIB_H
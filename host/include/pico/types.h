@@ -0,0 +1,12 @@
+// Host build: minimal stand-ins for the Pico SDK types
+#ifndef HOST_PICO_TYPES_H
+#define HOST_PICO_TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#endif // HOST_PICO_TYPES_H
@@ -0,0 +1,11 @@
+// Host build of the Pico SDK subset used by the game and the display driver.
+// Time is simulated: it only moves through sleep_*() and pico_host_advance_us(),
+// so runs are repeatable.
+#ifndef PICO_HOST_H
+#define PICO_HOST_H
+
+#include "pico/types.h"
+
+void pico_host_advance_us(uint64_t us);
+
+#endif // PICO_HOST_H
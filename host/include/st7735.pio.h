@@ -0,0 +1,24 @@
+// Host build: stands in for the header pico_generate_pio_header() makes from
+// pio/st7735.pio. The frames themselves are decoded in pico_host.c.
+#ifndef HOST_ST7735_PIO_H
+#define HOST_ST7735_PIO_H
+
+#include "hardware/pio.h"
+
+#define st7735_lcd_offset_start 0u
+
+static const pio_program_t st7735_lcd_program = {NULL, 0, -1};
+
+static inline void st7735_lcd_program_init(PIO pio, uint sm, uint offset, uint cs_pin, uint dc_pin,
+                                           uint mosi_pin, float bit_rate)
+{
+    (void)pio;
+    (void)sm;
+    (void)offset;
+    (void)cs_pin;
+    (void)dc_pin;
+    (void)mosi_pin;
+    (void)bit_rate;
+}
+
+#endif // HOST_ST7735_PIO_H
@@ -0,0 +1,45 @@
+// Simulated ST7735 panel for the host build. The real driver
+// (src/hal/displays/st7735.c) runs unchanged on top of pico_host.c; every
+// byte it puts on the bus, through SPI, DMA or the PIO display list, is
+// decoded here (CASET/RASET/RAMWR) into a 128x160 RGB565 surface.
+// MADCTL rotation is not modelled.
+#ifndef ST7735_HOST_H
+#define ST7735_HOST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ST7735_HOST_WIDTH 128
+#define ST7735_HOST_HEIGHT 160
+
+typedef struct
+{
+    uint64_t bytes;        // every byte on the bus, commands included
+    uint32_t commands;     // bytes sent with D/C low
+    uint32_t windows;      // RAMWR commands (one per address window)
+    uint32_t transactions; // CS assertions (SPI path only)
+} st7735_host_stats_t;
+
+// Board wiring as in init_display(); change before the first transfer if needed
+void st7735_host_set_pins(unsigned cs_pin, unsigned dc_pin);
+
+// Row-major RGB565 pixels, as the panel shows them
+const uint16_t *st7735_host_surface(void);
+uint32_t st7735_host_surface_hash(void);
+
+void st7735_host_get_stats(st7735_host_stats_t *stats);
+void st7735_host_reset_stats(void);
+
+// Writes the surface as a binary PPM (P6). Returns false on I/O errors.
+bool st7735_host_dump_ppm(const char *path);
+
+// Compares the surface with a PPM written by st7735_host_dump_ppm(). Returns
+// the number of differing pixels, or -1 if the file cannot be read.
+int st7735_host_compare_ppm(const char *path);
+
+// Bus input, called by pico_host.c
+void st7735_host_gpio(unsigned pin, bool value);
+void st7735_host_spi_byte(uint8_t byte);
+void st7735_host_frame_byte(bool dc, uint8_t byte);
+
+#endif // ST7735_HOST_H
@@ -0,0 +1,205 @@
+// Plays the game headless and records its sound (game/audio.h) to a WAV
+// file: after every tick the mixer is asked for the samples that tick
+// covers, in buffers of the size the PWM driver refills on the board, so
+// the file holds exactly what the speaker would get. Reports the mixing
+// cost per buffer against the time the buffer plays, and the mixer's
+// counters. The board's figure is in the firmware's per-second report.
+//
+//   audio_wav [-n ticks] [-s seed] [-i script|random] [-o out.wav]
+#include "game/audio.h"
+#include "game/game.h"
+#include "game/gamestate.h"
+#include "game/replay.h"
+#include "hal/audio/pwm_audio.h"
+#include "pico_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BUFFER PWM_AUDIO_BUFFER_SAMPLES
+
+static uint32_t _input_rng = 1;
+static int16_t _buffer[BUFFER];
+static uint64_t _mix_ns_total;
+static uint32_t _mix_ns_max;
+static uint32_t _buffers;
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Same players as game_sim
+static void scripted_input(uint32_t tick, int8_t *move, bool *fire)
+{
+    static const int8_t sweep[] = {127, 90, 40, -40, -90, -127, -64, 0};
+    *move = sweep[(tick / 60) % 8];
+    *fire = (tick / 10) % 3 != 0;
+}
+
+static void random_input(uint32_t tick, int8_t *move, bool *fire)
+{
+    static int8_t held_move;
+    static bool held_fire;
+    if (tick % 8 == 0)
+    {
+        _input_rng = _input_rng * 1664525u + 1013904223u;
+        held_move = (int8_t)((int)(_input_rng >> 16) % 255 - 127);
+        held_fire = (_input_rng >> 8) & 1;
+    }
+    *move = held_move;
+    *fire = held_fire;
+}
+
+static void put_u16(FILE *f, uint16_t v)
+{
+    fputc(v & 0xFF, f);
+    fputc(v >> 8, f);
+}
+
+static void put_u32(FILE *f, uint32_t v)
+{
+    put_u16(f, (uint16_t)v);
+    put_u16(f, (uint16_t)(v >> 16));
+}
+
+// 16-bit mono PCM; the sizes are patched in once the length is known
+static void write_header(FILE *f, uint32_t samples)
+{
+    fwrite("RIFF", 1, 4, f);
+    put_u32(f, 36 + samples * 2);
+    fwrite("WAVEfmt ", 1, 8, f);
+    put_u32(f, 16);
+    put_u16(f, 1); // PCM
+    put_u16(f, 1); // mono
+    put_u32(f, AUDIO_SAMPLE_RATE);
+    put_u32(f, AUDIO_SAMPLE_RATE * 2);
+    put_u16(f, 2);
+    put_u16(f, 16);
+    fwrite("data", 1, 4, f);
+    put_u32(f, samples * 2);
+}
+
+// One buffer as the DMA interrupt would mix it, written little-endian;
+// returns the peak magnitude
+static int mix_buffer(FILE *f)
+{
+    uint64_t start = host_now_ns();
+    audio_mix(_buffer, BUFFER);
+    uint32_t ns = (uint32_t)(host_now_ns() - start);
+    _mix_ns_total += ns;
+    if (ns > _mix_ns_max)
+    {
+        _mix_ns_max = ns;
+    }
+    _buffers++;
+
+    int peak = 0;
+    for (int i = 0; i < BUFFER; i++)
+    {
+        put_u16(f, (uint16_t)_buffer[i]);
+        int m = abs(_buffer[i]);
+        if (m > peak)
+        {
+            peak = m;
+        }
+    }
+    return peak;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t ticks = 120 * 60;
+    uint32_t seed = 1;
+    bool random = false;
+    const char *path = "game.wav";
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:i:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            ticks = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            random = strcmp(optarg, "random") == 0;
+            break;
+        case 'o':
+            path = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n ticks] [-s seed] [-i script|random] [-o out.wav]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        perror(path);
+        return 1;
+    }
+    write_header(f, 0);
+
+    game_init();
+    audio_init();
+    game_seed(seed);
+    game_reset();
+    _input_rng = seed;
+
+    // Samples owed so far: tick t ends at (t + 1) * rate / tick rate
+    uint64_t owed = 0;
+    uint32_t written = 0;
+    int peak = 0;
+    for (uint32_t t = 0; t < ticks; t++)
+    {
+        int8_t move;
+        bool fire;
+        if (get_state() != GAMESTATE_PLAYING)
+        {
+            move = -127; // start, or restart after a game over
+            fire = false;
+        }
+        else if (random)
+        {
+            random_input(t, &move, &fire);
+        }
+        else
+        {
+            scripted_input(t, &move, &fire);
+        }
+        game_tick(replay_move(move), fire);
+        pico_host_advance_us(GAME_TICK_US);
+
+        owed = (uint64_t)(t + 1) * AUDIO_SAMPLE_RATE / GAME_TICK_HZ;
+        while (owed - written >= BUFFER)
+        {
+            int p = mix_buffer(f);
+            peak = p > peak ? p : peak;
+            written += BUFFER;
+        }
+    }
+
+    fseek(f, 0, SEEK_SET);
+    write_header(f, written);
+    fclose(f);
+
+    audio_stats_t stats;
+    audio_get_stats(&stats);
+    double budget_ns = BUFFER * 1e9 / AUDIO_SAMPLE_RATE;
+    double mean_ns = _buffers ? (double)_mix_ns_total / _buffers : 0;
+    printf("%s: %u samples at %d Hz (%.1f s), %s input, seed %u, peak %d\n", path, written, AUDIO_SAMPLE_RATE,
+           (double)written / AUDIO_SAMPLE_RATE, random ? "random" : "scripted", seed, peak);
+    printf("mix ns per %d-sample buffer: mean %.0f, max %u (%.3f%% of the %.0f us it plays)\n", BUFFER, mean_ns,
+           _mix_ns_max, 100.0 * mean_ns / budget_ns, budget_ns / 1000.0);
+    printf("%u buffers, %u sounds played, %u dropped, %u samples clipped\n", stats.buffers, stats.played,
+           stats.dropped, stats.clipped);
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Collision cost per tick as bullets and enemies scale into the hundreds:
+// every bullet against every enemy, as game.c used to test them, versus
+// rebuilding the uniform-grid broadphase (game/broadphase.h) and querying
+// it once per bullet. Both must find the same pairs.
+//
+//   collision_bench [-t ticks]
+#include "game/broadphase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FIELD_W 128
+#define FIELD_H 160
+#define MAX_OBJECTS 512
+
+typedef struct
+{
+    int x, y, w, h;
+} box_t;
+
+static box_t _bullets[MAX_OBJECTS];
+static box_t _enemies[MAX_OBJECTS];
+static broadphase_t _grid;
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static bool overlaps(const box_t *a, const box_t *b)
+{
+    return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+static void place(box_t *boxes, int n, int w, int h)
+{
+    for (int i = 0; i < n; i++)
+    {
+        boxes[i].x = rand() % (FIELD_W - w);
+        boxes[i].y = rand() % (FIELD_H - h);
+        boxes[i].w = w;
+        boxes[i].h = h;
+    }
+}
+
+// Bullets fly up one pixel per tick and wrap, so the grid sees new
+// positions every tick
+static void move_bullets(int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        if (--_bullets[i].y < 0)
+        {
+            _bullets[i].y = FIELD_H - _bullets[i].h;
+        }
+    }
+}
+
+static uint32_t brute_tick(int bullets, int enemies)
+{
+    uint32_t pairs = 0;
+    for (int b = 0; b < bullets; b++)
+    {
+        for (int e = 0; e < enemies; e++)
+        {
+            pairs += overlaps(&_bullets[b], &_enemies[e]);
+        }
+    }
+    return pairs;
+}
+
+static uint32_t grid_tick(int bullets, int enemies)
+{
+    static uint16_t ids[MAX_OBJECTS];
+    broadphase_clear(&_grid);
+    for (int e = 0; e < enemies; e++)
+    {
+        broadphase_insert(&_grid, _enemies[e].x, _enemies[e].y, _enemies[e].w, _enemies[e].h, BROADPHASE_ENEMY,
+                          (uint16_t)e);
+    }
+    for (int b = 0; b < bullets; b++)
+    {
+        broadphase_insert(&_grid, _bullets[b].x, _bullets[b].y, _bullets[b].w, _bullets[b].h,
+                          BROADPHASE_PLAYER_BULLET, (uint16_t)b);
+    }
+
+    uint32_t pairs = 0;
+    for (int b = 0; b < bullets; b++)
+    {
+        pairs += broadphase_query(&_grid, _bullets[b].x, _bullets[b].y, _bullets[b].w, _bullets[b].h,
+                                  BROADPHASE_ENEMY, ids, MAX_OBJECTS);
+    }
+    return pairs;
+}
+
+static void bench(int n, int ticks)
+{
+    srand(n);
+    place(_bullets, n, 2, 6);
+    place(_enemies, n, 10, 8);
+
+    uint32_t brute_pairs = 0;
+    uint64_t start = host_now_ns();
+    for (int t = 0; t < ticks; t++)
+    {
+        brute_pairs += brute_tick(n, n);
+        move_bullets(n);
+    }
+    double brute_us = (host_now_ns() - start) / 1000.0 / ticks;
+
+    srand(n);
+    place(_bullets, n, 2, 6);
+    place(_enemies, n, 10, 8);
+
+    uint32_t grid_pairs = 0;
+    start = host_now_ns();
+    for (int t = 0; t < ticks; t++)
+    {
+        grid_pairs += grid_tick(n, n);
+        move_bullets(n);
+    }
+    double grid_us = (host_now_ns() - start) / 1000.0 / ticks;
+
+    printf("%5d %5d %10.2f %10.2f %8.1fx   %s\n", n, n, brute_us, grid_us, brute_us / grid_us,
+           brute_pairs == grid_pairs ? "same" : "DIFFERENT");
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = 2000;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t ticks]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("us per tick, %d ticks, %dx%d px cells\n", ticks, 1 << BROADPHASE_CELL_SHIFT, 1 << BROADPHASE_CELL_SHIFT);
+    printf("%5s %5s %10s %10s %9s   %s\n", "bull", "enem", "all pairs", "grid", "speedup", "pairs");
+    for (int n = 16; n <= MAX_OBJECTS; n *= 2)
+    {
+        bench(n, ticks);
+    }
+    return 0;
+}
@@ -0,0 +1,215 @@
+// Entity store (game/entities.h, one array per component) against the
+// layout it replaced: a pool of structs reached through a dense index
+// array, as the projectile pool stored shots. Both run the same systems
+// per tick: move, cull what left the screen (and respawn it, so the count
+// stays constant) and submit everything to the broadphase.
+//
+//   entity_bench [-t ticks]
+#include "game/entities.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FIELD_W 128
+#define FIELD_H 160
+
+static const entity_def_t _shot_def = {ENTITY_PLAYER_SHOT, 2, 6, BROADPHASE_PLAYER_BULLET, ENTITY_CULL, 0xF800, NULL};
+
+// ---- Pool of structs with a dense index, the previous layout ----
+
+typedef struct
+{
+    fix16_t x, y, vx, vy;
+    uint16_t color;
+    uint8_t owner;
+    uint16_t dense;
+} aos_body_t;
+
+static aos_body_t _slots[ENTITY_MAX];
+static uint16_t _free_list[ENTITY_MAX];
+static uint16_t _active[ENTITY_MAX];
+static int _free_count;
+static int _active_count;
+
+static void aos_init(void)
+{
+    for (int i = 0; i < ENTITY_MAX; i++)
+    {
+        _free_list[i] = (uint16_t)(ENTITY_MAX - 1 - i);
+    }
+    _free_count = ENTITY_MAX;
+    _active_count = 0;
+}
+
+static void aos_spawn(fix16_t x, fix16_t y, fix16_t vx, fix16_t vy)
+{
+    int slot = _free_list[--_free_count];
+    aos_body_t *p = &_slots[slot];
+    p->x = x;
+    p->y = y;
+    p->vx = vx;
+    p->vy = vy;
+    p->color = 0xF800;
+    p->owner = 0;
+    p->dense = (uint16_t)_active_count;
+    _active[_active_count++] = (uint16_t)slot;
+}
+
+static void aos_despawn(int slot)
+{
+    aos_body_t *p = &_slots[slot];
+    int last = _active[--_active_count];
+    _active[p->dense] = (uint16_t)last;
+    _slots[last].dense = p->dense;
+    _free_list[_free_count++] = (uint16_t)slot;
+}
+
+// ---- Harness ----
+
+static broadphase_t _grid;
+static uint32_t _rng = 1;
+
+static uint32_t next_rand(void)
+{
+    _rng = _rng * 1664525u + 1013904223u;
+    return _rng >> 8;
+}
+
+static void random_body(fix16_t *x, fix16_t *y, fix16_t *vx, fix16_t *vy)
+{
+    *x = fix16_from_int((int)(next_rand() % FIELD_W));
+    *y = fix16_from_int((int)(next_rand() % FIELD_H));
+    *vx = fix16_from_int((int)(next_rand() % 41) - 20);
+    *vy = -fix16_from_int(60 + (int)(next_rand() % 80));
+}
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static double _move_us;
+
+static double bench_aos(int n, int ticks, uint32_t *culled)
+{
+    aos_init();
+    _rng = 1;
+    for (int i = 0; i < n; i++)
+    {
+        fix16_t x, y, vx, vy;
+        random_body(&x, &y, &vx, &vy);
+        aos_spawn(x, y, vx, vy);
+    }
+
+    *culled = 0;
+    uint64_t move_ns = 0;
+    uint64_t start = host_now_ns();
+    for (int t = 0; t < ticks; t++)
+    {
+        uint64_t move_start = host_now_ns();
+        for (int i = _active_count - 1; i >= 0; i--)
+        {
+            int slot = _active[i];
+            aos_body_t *p = &_slots[slot];
+            p->x += fix16_distance(p->vx, 8333);
+            p->y += fix16_distance(p->vy, 8333);
+            int x = fix16_to_int(p->x);
+            int y = fix16_to_int(p->y);
+            if (x < 0 || x > FIELD_W || y < 0 || y > FIELD_H)
+            {
+                aos_despawn(slot);
+                (*culled)++;
+            }
+        }
+        while (_active_count < n)
+        {
+            fix16_t x, y, vx, vy;
+            random_body(&x, &y, &vx, &vy);
+            aos_spawn(x, y, vx, vy);
+        }
+        move_ns += host_now_ns() - move_start;
+
+        broadphase_clear(&_grid);
+        for (int i = 0; i < _active_count; i++)
+        {
+            const aos_body_t *p = &_slots[_active[i]];
+            broadphase_insert(&_grid, fix16_to_int(p->x), fix16_to_int(p->y), 2, 6, BROADPHASE_PLAYER_BULLET,
+                              _active[i]);
+        }
+    }
+    _move_us = move_ns / 1000.0 / ticks;
+    return (host_now_ns() - start) / 1000.0 / ticks;
+}
+
+static double bench_soa(int n, int ticks, uint32_t *culled)
+{
+    entities_init();
+    _rng = 1;
+    for (int i = 0; i < n; i++)
+    {
+        fix16_t x, y, vx, vy;
+        random_body(&x, &y, &vx, &vy);
+        entities_spawn(&_shot_def, x, y, vx, vy);
+    }
+
+    entity_stats_t stats;
+    entities_get_stats(&stats);
+    uint32_t spawned_before = stats.spawned;
+    uint64_t move_ns = 0;
+    uint64_t start = host_now_ns();
+    for (int t = 0; t < ticks; t++)
+    {
+        uint64_t move_start = host_now_ns();
+        entities_move(8333);
+        while (entities_count(ENTITY_PLAYER_SHOT) < n)
+        {
+            fix16_t x, y, vx, vy;
+            random_body(&x, &y, &vx, &vy);
+            entities_spawn(&_shot_def, x, y, vx, vy);
+        }
+        move_ns += host_now_ns() - move_start;
+
+        broadphase_clear(&_grid);
+        entities_submit(&_grid);
+    }
+    double us = (host_now_ns() - start) / 1000.0 / ticks;
+    _move_us = move_ns / 1000.0 / ticks;
+    entities_get_stats(&stats);
+    *culled = stats.spawned - spawned_before;
+    return us;
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = 5000;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t ticks]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("us per tick, %d ticks: move = move, cull and respawn; total adds the broadphase submit\n", ticks);
+    printf("%6s %10s %10s %10s %10s   %s\n", "n", "aos move", "soa move", "aos total", "soa total", "culled");
+    for (int n = 64; n <= ENTITY_MAX; n *= 2)
+    {
+        uint32_t aos_culled, soa_culled;
+        double aos_us = bench_aos(n, ticks, &aos_culled);
+        double aos_move_us = _move_us;
+        double soa_us = bench_soa(n, ticks, &soa_culled);
+        double soa_move_us = _move_us;
+        printf("%6d %10.2f %10.2f %10.2f %10.2f   %s\n", n, aos_move_us, soa_move_us, aos_us, soa_us,
+               aos_culled == soa_culled ? "same" : "DIFFERENT");
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+// Compares the bitmask formation (game/formation.h) with the array of
+// structs it replaced: one move step with edge detection, and bullet hit
+// tests, for the game's 3x6 grid, the classic 5x11 and a full 8x16.
+//
+//   formation_bench [-i iterations]
+#include "game/formation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SCREEN_WIDTH 128
+#define CELL_W 10
+#define CELL_H 8
+#define COL_PITCH 12
+#define ROW_PITCH 12
+#define BULLETS 8 // hit tests per iteration, like a screen full of shots
+
+// ---- Array of structs, as enemies.c stored the formation before ----
+
+typedef struct
+{
+    int x, y;
+    bool alive;
+} aos_enemy_t;
+
+typedef struct
+{
+    aos_enemy_t enemies[FORMATION_MAX_ROWS * FORMATION_MAX_COLS];
+    int count;
+    int dir;
+} aos_formation_t;
+
+static void aos_init(aos_formation_t *f, int rows, int cols)
+{
+    f->count = 0;
+    f->dir = 1;
+    for (int row = 0; row < rows; row++)
+    {
+        for (int col = 0; col < cols; col++)
+        {
+            aos_enemy_t *e = &f->enemies[f->count++];
+            e->x = 2 + col * COL_PITCH;
+            e->y = 20 + row * ROW_PITCH;
+            e->alive = true;
+        }
+    }
+}
+
+static void aos_step(aos_formation_t *f)
+{
+    bool edge_hit = false;
+    for (int i = 0; i < f->count; i++)
+    {
+        if (!f->enemies[i].alive)
+        {
+            continue;
+        }
+        f->enemies[i].x += f->dir * 2;
+        if (f->enemies[i].x <= 0 || f->enemies[i].x >= SCREEN_WIDTH - CELL_W)
+        {
+            edge_hit = true;
+        }
+    }
+    if (edge_hit)
+    {
+        f->dir *= -1;
+        for (int i = 0; i < f->count; i++)
+        {
+            f->enemies[i].y += 5;
+        }
+    }
+}
+
+static bool aos_hit(aos_formation_t *f, int px, int py)
+{
+    for (int i = 0; i < f->count; i++)
+    {
+        aos_enemy_t *e = &f->enemies[i];
+        if (!e->alive)
+        {
+            continue;
+        }
+        if (px >= e->x && px <= e->x + CELL_W && py >= e->y && py <= e->y + CELL_H)
+        {
+            e->alive = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---- Bitmask formation ----
+
+static int _mask_dir = 1;
+
+static void mask_step(formation_t *f)
+{
+    f->x += _mask_dir * 2;
+    if (f->alive_count > 0 && (formation_left(f) <= 0 || formation_right(f) >= SCREEN_WIDTH - CELL_W))
+    {
+        _mask_dir *= -1;
+        f->y += 5;
+    }
+}
+
+// ---- Harness ----
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Bullet positions spread over the formation's area and the gaps around
+// it; most miss, so the array version usually scans every entry.
+static void make_shots(int *xs, int *ys, int n, int rows, int seed)
+{
+    srand(seed);
+    for (int i = 0; i < n; i++)
+    {
+        xs[i] = rand() % SCREEN_WIDTH;
+        ys[i] = 10 + rand() % (rows * ROW_PITCH + 40);
+    }
+}
+
+static void bench_grid(int rows, int cols, int iterations)
+{
+    static aos_formation_t aos;
+    static formation_t mask;
+    static int xs[BULLETS * 1024], ys[BULLETS * 1024];
+    const int shots = BULLETS * 1024;
+    volatile int sink = 0;
+
+    // Moving: no kills, so every step touches the full formation
+    aos_init(&aos, rows, cols);
+    uint64_t start = host_now_ns();
+    for (int i = 0; i < iterations; i++)
+    {
+        aos_step(&aos);
+        if (aos.enemies[0].y > 100)
+        {
+            aos_init(&aos, rows, cols);
+        }
+    }
+    double aos_step_ns = (double)(host_now_ns() - start) / iterations;
+
+    formation_init(&mask, rows, cols, 2, 20, COL_PITCH, ROW_PITCH, CELL_W, CELL_H);
+    _mask_dir = 1;
+    start = host_now_ns();
+    for (int i = 0; i < iterations; i++)
+    {
+        mask_step(&mask);
+        if (mask.y > 100)
+        {
+            formation_init(&mask, rows, cols, 2, 20, COL_PITCH, ROW_PITCH, CELL_W, CELL_H);
+        }
+    }
+    double mask_step_ns = (double)(host_now_ns() - start) / iterations;
+
+    // Hit tests against a formation that loses invaders as it is hit; it
+    // is rebuilt once half of it is gone
+    make_shots(xs, ys, shots, rows, 1);
+    int aos_hits = 0;
+    aos_init(&aos, rows, cols);
+    start = host_now_ns();
+    for (int i = 0; i < iterations; i++)
+    {
+        for (int b = 0; b < BULLETS; b++)
+        {
+            int s = (i * BULLETS + b) % shots;
+            if (aos_hit(&aos, xs[s], ys[s]) && ++aos_hits % (rows * cols / 2 + 1) == 0)
+            {
+                aos_init(&aos, rows, cols);
+            }
+        }
+    }
+    double aos_hit_ns = (double)(host_now_ns() - start) / iterations / BULLETS;
+
+    int mask_hits = 0;
+    formation_init(&mask, rows, cols, 2, 20, COL_PITCH, ROW_PITCH, CELL_W, CELL_H);
+    start = host_now_ns();
+    for (int i = 0; i < iterations; i++)
+    {
+        for (int b = 0; b < BULLETS; b++)
+        {
+            int s = (i * BULLETS + b) % shots;
+            if (formation_hit(&mask, xs[s], ys[s]) && ++mask_hits % (rows * cols / 2 + 1) == 0)
+            {
+                formation_init(&mask, rows, cols, 2, 20, COL_PITCH, ROW_PITCH, CELL_W, CELL_H);
+            }
+        }
+    }
+    double mask_hit_ns = (double)(host_now_ns() - start) / iterations / BULLETS;
+    sink += aos_hits + mask_hits;
+
+    printf("%2dx%-2d %4d   %8.1f %8.1f   %8.1f %8.1f   %s\n", rows, cols, rows * cols, aos_step_ns,
+           mask_step_ns, aos_hit_ns, mask_hit_ns, aos_hits == mask_hits ? "same" : "DIFFERENT");
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 200000;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            iterations = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-i iterations]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("ns per call, %d iterations\n", iterations);
+    printf("%-5s %4s   %8s %8s   %8s %8s   %s\n", "grid", "n", "aos step", "mask", "aos hit", "mask", "hits");
+    bench_grid(3, 6, iterations);
+    bench_grid(5, 11, iterations);
+    bench_grid(8, 16, iterations);
+    return 0;
+}
@@ -0,0 +1,231 @@
+// Runs the game headless as fast as the host allows: game_tick() in a
+// tight loop on the simulated SDK, fed by a scripted player or random
+// input, with nothing drawn unless asked for. Reports simulated ticks per
+// second and the distribution of the time each tick took, for working on
+// the engine's hot paths without the board.
+//
+// With -c, frames go through the render queue to a second thread standing
+// in for core 1, as in the dual-core firmware; the tick latency then shows
+// whether drawing still reaches the simulation.
+//
+//   game_sim [-n ticks] [-s seed] [-i script|random] [-r render_every] [-c]
+#include "game/game.h"
+#include "game/gamestate.h"
+#include "game/render_queue.h"
+#include "game/replay.h"
+#include "hal/displays/st7735.h"
+#include "pico/multicore.h"
+#include "pico_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint32_t _input_rng = 1;
+static render_queue_t _queue;
+
+static void render_core_main(void)
+{
+    while (true)
+    {
+        const render_frame_t *frame = render_queue_peek(&_queue);
+        if (!frame)
+        {
+            tight_loop_contents();
+            continue;
+        }
+        game_draw_frame(frame);
+        render_queue_release(&_queue);
+    }
+}
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Same player as st7735_replay: sweeps at varying deflections, fires in
+// bursts and starts a new game after each game over
+static void scripted_input(uint32_t tick, int8_t *move, bool *fire)
+{
+    static const int8_t sweep[] = {127, 90, 40, -40, -90, -127, -64, 0};
+    *move = sweep[(tick / 60) % 8];
+    *fire = (tick / 10) % 3 != 0;
+}
+
+// New random stick position and trigger every 8 ticks (~15 Hz)
+static void random_input(uint32_t tick, int8_t *move, bool *fire)
+{
+    static int8_t held_move;
+    static bool held_fire;
+    if (tick % 8 == 0)
+    {
+        _input_rng = _input_rng * 1664525u + 1013904223u;
+        held_move = (int8_t)((int)(_input_rng >> 16) % 255 - 127);
+        held_fire = (_input_rng >> 8) & 1;
+    }
+    *move = held_move;
+    *fire = held_fire;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(const uint32_t *sorted, uint32_t n, double p)
+{
+    uint32_t i = (uint32_t)(p / 100.0 * (n - 1) + 0.5);
+    return sorted[i];
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t ticks = 1000000;
+    uint32_t seed = 1;
+    int render_every = 0;
+    bool random = false;
+    bool dual_core = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:s:i:r:c")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            ticks = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            random = strcmp(optarg, "random") == 0;
+            break;
+        case 'r':
+            render_every = atoi(optarg);
+            break;
+        case 'c':
+            dual_core = true;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n ticks] [-s seed] [-i script|random] [-r render_every] [-c]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (ticks == 0)
+    {
+        ticks = 1;
+    }
+
+    uint32_t *tick_ns = malloc(ticks * sizeof(uint32_t));
+    if (!tick_ns)
+    {
+        fprintf(stderr, "cannot allocate %u samples\n", ticks);
+        return 1;
+    }
+
+    game_init();
+    game_seed(seed);
+    game_reset();
+    _input_rng = seed;
+    if (dual_core)
+    {
+        render_queue_init(&_queue);
+        multicore_launch_core1(render_core_main);
+    }
+
+    uint32_t games = 0;
+    uint32_t frames = 0;
+    gamestate_t last_state = get_state();
+    uint64_t render_ns = 0;
+    uint64_t start = host_now_ns();
+    for (uint32_t t = 0; t < ticks; t++)
+    {
+        int8_t move;
+        bool fire;
+        if (get_state() != GAMESTATE_PLAYING)
+        {
+            move = -127; // start, or restart after a game over
+            fire = false;
+        }
+        else if (random)
+        {
+            random_input(t, &move, &fire);
+        }
+        else
+        {
+            scripted_input(t, &move, &fire);
+        }
+
+        uint64_t tick_start = host_now_ns();
+        game_tick(replay_move(move), fire);
+        uint64_t tick_end = host_now_ns();
+        tick_ns[t] = (uint32_t)(tick_end - tick_start);
+        pico_host_advance_us(GAME_TICK_US);
+
+        if (get_state() != last_state)
+        {
+            games += get_state() == GAMESTATE_PLAYING;
+            last_state = get_state();
+        }
+        if (render_every > 0 && (t + 1) % render_every == 0)
+        {
+            if (!dual_core)
+            {
+                game_render();
+                frames++;
+            }
+            else
+            {
+                render_frame_t *frame = render_queue_begin(&_queue);
+                if (frame)
+                {
+                    game_build_frame(frame);
+                    render_queue_publish(&_queue);
+                    frames++;
+                }
+            }
+            render_ns += host_now_ns() - tick_end;
+        }
+    }
+    double wall_s = (host_now_ns() - start) / 1e9;
+    while (dual_core && render_queue_depth(&_queue) > 0)
+    {
+        tight_loop_contents();
+    }
+    st7735_wait();
+
+    uint64_t sum_ns = 0;
+    for (uint32_t t = 0; t < ticks; t++)
+    {
+        sum_ns += tick_ns[t];
+    }
+    qsort(tick_ns, ticks, sizeof(uint32_t), compare_u32);
+
+    printf("%u ticks (%.1f s of game time), %s input, seed %u, %u games started\n", ticks,
+           ticks / (double)GAME_TICK_HZ, random ? "random" : "scripted", seed, games);
+    printf("%.0f ticks/s, %.0fx real time, state %08x\n", ticks / wall_s, ticks / wall_s / GAME_TICK_HZ,
+           (unsigned)game_state_hash());
+    printf("tick ns: mean %.0f, p50 %u, p90 %u, p99 %u, p99.9 %u, max %u\n", (double)sum_ns / ticks,
+           percentile(tick_ns, ticks, 50), percentile(tick_ns, ticks, 90), percentile(tick_ns, ticks, 99),
+           percentile(tick_ns, ticks, 99.9), tick_ns[ticks - 1]);
+    if (frames > 0)
+    {
+        printf("%u frames %s, %.1f us mean on the simulation thread\n", frames, dual_core ? "queued" : "rendered",
+               render_ns / 1000.0 / frames);
+    }
+    if (dual_core)
+    {
+        render_queue_stats_t queue;
+        render_queue_get_stats(&_queue, &queue);
+        printf("render queue: %u drawn, max depth %u of %d, %u producer stalls\n", queue.rendered, queue.depth_max,
+               RENDER_QUEUE_DEPTH, queue.stalls);
+    }
+    free(tick_ns);
+    return 0;
+}
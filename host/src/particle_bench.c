@@ -0,0 +1,134 @@
+// Particle system cost per 60 fps frame (game/particles.h) as the pool
+// fills up: two 120 Hz updates, building the point batch, and drawing it
+// through the real driver onto the simulated panel. The batch (one
+// st7735_draw_points() call) runs against the same particles drawn as one
+// st7735_draw_pixel() each, the way a sprite-per-object renderer would.
+// Both must leave the same picture (except in strip mode, where single
+// pixels overflow the driver's command list from 256 on); bytes are what
+// the driver sends.
+// The board's figure comes from the particle_bench demo (demos/).
+//
+//   particle_bench [-m dirty|strip] [-f frames]
+#include "game/game.h"
+#include "game/particles.h"
+#include "game/render_queue.h"
+#include "st7735_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TICKS_PER_FRAME (GAME_TICK_HZ / 60)
+
+static render_frame_t _frame;
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void top_up(int n)
+{
+    while (particles_count() < n)
+    {
+        int missing = n - particles_count();
+        particles_burst(8 + rand() % 112, 16 + rand() % 112, missing < 24 ? missing : 24, FIX16(70),
+                        PARTICLE_RAMP_FIRE);
+    }
+}
+
+// us per frame for update plus draw; the panel hash and bytes per frame
+// come back through the pointers
+static double bench(int n, int frames, bool batched, double *update_us, uint32_t *hash, double *bytes)
+{
+    uint64_t update_ns = 0, draw_ns = 0;
+    st7735_fill_screen(0);
+    st7735_present();
+    st7735_wait();
+    uint32_t sent = st7735_get_bytes_sent();
+
+    particles_init();
+    srand(n);
+    for (int f = 0; f < frames; f++)
+    {
+        top_up(n);
+        uint64_t start = host_now_ns();
+        for (int t = 0; t < TICKS_PER_FRAME; t++)
+        {
+            particles_update(GAME_TICK_US);
+        }
+        uint64_t updated = host_now_ns();
+        _frame.point_count = 0;
+        particles_draw(&_frame);
+        st7735_begin_frame(0);
+        if (batched)
+        {
+            st7735_draw_points(_frame.points, _frame.point_count);
+        }
+        else
+        {
+            for (int i = 0; i < _frame.point_count; i++)
+            {
+                st7735_draw_pixel(_frame.points[i].x, _frame.points[i].y, _frame.points[i].color);
+            }
+        }
+        st7735_present();
+        uint64_t end = host_now_ns();
+        st7735_wait();
+        update_ns += updated - start;
+        draw_ns += end - updated;
+    }
+    *update_us = update_ns / 1000.0 / frames;
+    *hash = st7735_host_surface_hash();
+    *bytes = (double)(st7735_get_bytes_sent() - sent) / frames;
+    return (update_ns + draw_ns) / 1000.0 / frames;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = 2000;
+    bool strip = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:f:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm':
+            strip = strcmp(optarg, "strip") == 0;
+            break;
+        case 'f':
+            frames = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-m dirty|strip] [-f frames]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    game_init();
+    if (strip)
+    {
+        st7735_set_strip_mode(true);
+    }
+
+    printf("us per frame, %d frames, %s renderer; bytes sent per frame\n", frames, strip ? "strip" : "dirty");
+    printf("%5s %8s %10s %10s %10s %10s   %s\n", "count", "update", "batch", "per pixel", "bytes", "bytes",
+           "panel");
+    for (int n = 64; n <= PARTICLE_MAX; n *= 2)
+    {
+        double update_us, unused_us, batch_bytes, pixel_bytes;
+        uint32_t batch_hash, pixel_hash;
+        double batch_us = bench(n, frames, true, &update_us, &batch_hash, &batch_bytes);
+        double pixel_us = bench(n, frames, false, &unused_us, &pixel_hash, &pixel_bytes);
+        printf("%5d %8.2f %10.2f %10.2f %10.0f %10.0f   %s\n", n, update_us, batch_us, pixel_us, batch_bytes,
+               pixel_bytes, batch_hash == pixel_hash ? "same" : "DIFFERENT");
+    }
+
+    particle_stats_t stats;
+    particles_get_stats(&stats);
+    printf("pool %u, high water %u, %lu dropped\n", stats.capacity, stats.high_water, (unsigned long)stats.dropped);
+    return 0;
+}
@@ -0,0 +1,537 @@
+// Host implementation of the Pico SDK calls used by the game and drivers.
+// Bus traffic is forwarded to the simulated panel in st7735_host.c.
+#include "pico_host.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/pio.h"
+#include "hardware/spi.h"
+#include "pico/multicore.h"
+#include "pico/stdlib.h"
+#include "st7735_host.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+// ---- Time ----
+
+static uint64_t _now_us = 0;
+
+void pico_host_advance_us(uint64_t us)
+{
+    _now_us += us;
+}
+
+uint64_t time_us_64(void)
+{
+    return _now_us;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)_now_us;
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return _now_us;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to)
+{
+    return (int64_t)(to - from);
+}
+
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us)
+{
+    return t + us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms)
+{
+    return _now_us + ms * 1000ull;
+}
+
+bool time_reached(absolute_time_t t)
+{
+    return _now_us >= t;
+}
+
+void sleep_us(uint64_t us)
+{
+    _now_us += us;
+}
+
+void sleep_ms(uint32_t ms)
+{
+    _now_us += ms * 1000ull;
+}
+
+void sleep_until(absolute_time_t t)
+{
+    if (t > _now_us)
+    {
+        _now_us = t;
+    }
+}
+
+void stdio_init_all(void)
+{
+}
+
+// ---- GPIO ----
+
+static bool _gpio[48];
+
+void gpio_init(uint gpio)
+{
+    (void)gpio;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    _gpio[gpio] = value;
+    st7735_host_gpio(gpio, value);
+}
+
+bool gpio_get(uint gpio)
+{
+    return _gpio[gpio];
+}
+
+void gpio_pull_up(uint gpio)
+{
+    _gpio[gpio] = true;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+// ---- SPI ----
+
+struct spi_inst
+{
+    spi_hw_t hw;
+    uint baudrate;
+    uint data_bits;
+};
+
+static struct spi_inst _spi[2];
+spi_inst_t *spi0 = &_spi[0];
+spi_inst_t *spi1 = &_spi[1];
+
+uint spi_init(spi_inst_t *spi, uint baudrate)
+{
+    // The RP2350 divides clk_sys (150 MHz) by an even prescaler
+    uint div = (150000000 + baudrate - 1) / baudrate;
+    div += div & 1;
+    spi->baudrate = 150000000 / div;
+    spi->data_bits = 8;
+    return spi->baudrate;
+}
+
+uint spi_get_baudrate(const spi_inst_t *spi)
+{
+    return spi->baudrate;
+}
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order)
+{
+    (void)cpol;
+    (void)cpha;
+    (void)order;
+    spi->data_bits = data_bits;
+}
+
+int spi_write_blocking(spi_inst_t *spi, const uint8_t *src, size_t len)
+{
+    (void)spi;
+    for (size_t i = 0; i < len; i++)
+    {
+        st7735_host_spi_byte(src[i]);
+    }
+    return (int)len;
+}
+
+int spi_write16_blocking(spi_inst_t *spi, const uint16_t *src, size_t len)
+{
+    (void)spi;
+    for (size_t i = 0; i < len; i++)
+    {
+        st7735_host_spi_byte(src[i] >> 8);
+        st7735_host_spi_byte(src[i] & 0xFF);
+    }
+    return (int)len;
+}
+
+bool spi_is_busy(const spi_inst_t *spi)
+{
+    (void)spi;
+    return false;
+}
+
+bool spi_is_readable(const spi_inst_t *spi)
+{
+    (void)spi;
+    return false;
+}
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi)
+{
+    return &spi->hw;
+}
+
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx)
+{
+    (void)spi;
+    (void)is_tx;
+    return 0;
+}
+
+// ---- PIO (st7735.pio frames) ----
+
+static pio_hw_t _pio_hw[2];
+PIO pio0 = &_pio_hw[0];
+PIO pio1 = &_pio_hw[1];
+
+// Frame decoder: a header word (bit 31 = D/C, bits 30..0 = bit count - 1)
+// followed by the payload, MSB first
+static bool _frame_open = false;
+static bool _frame_dc;
+static int64_t _frame_bits;
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+    (void)pio;
+    (void)program;
+    return 0;
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    (void)pio;
+    (void)required;
+    return 0;
+}
+
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx)
+{
+    (void)pio;
+    (void)sm;
+    (void)is_tx;
+    return 0;
+}
+
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+    (void)pio;
+    (void)sm;
+    if (!_frame_open)
+    {
+        _frame_open = true;
+        _frame_dc = data >> 31;
+        _frame_bits = (int64_t)(data & 0x7FFFFFFF) + 1;
+        return;
+    }
+    for (int shift = 24; shift >= 0 && _frame_bits > 0; shift -= 8, _frame_bits -= 8)
+    {
+        st7735_host_frame_byte(_frame_dc, (data >> shift) & 0xFF);
+    }
+    if (_frame_bits <= 0)
+    {
+        _frame_open = false;
+    }
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled)
+{
+    (void)pio;
+    (void)sm;
+    (void)enabled;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm)
+{
+    (void)pio;
+    (void)sm;
+}
+
+void pio_remove_program(PIO pio, const pio_program_t *program, uint loaded_offset)
+{
+    (void)pio;
+    (void)program;
+    (void)loaded_offset;
+}
+
+bool pio_sm_is_tx_fifo_empty(PIO pio, uint sm)
+{
+    (void)pio;
+    (void)sm;
+    return true;
+}
+
+uint8_t pio_sm_get_pc(PIO pio, uint sm)
+{
+    (void)pio;
+    (void)sm;
+    // The program idles at offset 0 (start) between frames
+    return _frame_open ? 1 : 0;
+}
+
+// ---- DMA ----
+
+typedef struct
+{
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    dma_channel_hw_t hw;
+} host_dma_channel_t;
+
+static host_dma_channel_t _dma[16];
+static int _dma_claimed = 0;
+
+// Layout of a display-list block as the driver writes it
+typedef struct
+{
+    uint32_t count;
+    const void *addr;
+} host_dl_block_t;
+
+int dma_claim_unused_channel(bool required)
+{
+    (void)required;
+    return _dma_claimed++;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    (void)channel;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    (void)channel;
+    dma_channel_config c = {DMA_SIZE_32, true, false, false};
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+    c->size = size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+    (void)c;
+    (void)incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+    (void)c;
+    (void)dreq;
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to)
+{
+    (void)c;
+    (void)chain_to;
+}
+
+void channel_config_set_bswap(dma_channel_config *c, bool bswap)
+{
+    c->bswap = bswap;
+}
+
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits)
+{
+    (void)write;
+    c->ring = size_bits != 0;
+}
+
+void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet)
+{
+    (void)c;
+    (void)irq_quiet;
+}
+
+// Runs a transfer into the SPI data register to completion.
+static void host_dma_run_spi(const host_dma_channel_t *ch, uint count)
+{
+    const struct spi_inst *spi = NULL;
+    for (size_t i = 0; i < count_of(_spi); i++)
+    {
+        if (ch->write_addr == &_spi[i].hw.dr)
+        {
+            spi = &_spi[i];
+        }
+    }
+    if (!spi)
+    {
+        return;
+    }
+    const uint8_t *src = (const uint8_t *)ch->read_addr;
+    int size = 1 << ch->config.size;
+    for (uint i = 0; i < count; i++)
+    {
+        const uint8_t *e = src + (ch->config.read_increment ? i * size : 0);
+        uint32_t value = 0;
+        memcpy(&value, e, size);
+        // Only the low data_bits of each transfer reach the FIFO
+        if (spi->data_bits == 16)
+        {
+            st7735_host_spi_byte((value >> 8) & 0xFF);
+        }
+        st7735_host_spi_byte(value & 0xFF);
+    }
+}
+
+// Runs a transfer into the PIO TX FIFO (solid fills) to completion.
+static void host_dma_run_pio(const host_dma_channel_t *ch, uint count)
+{
+    const uint32_t *words = (const uint32_t *)ch->read_addr;
+    for (uint i = 0; i < count; i++)
+    {
+        uint32_t word = words[ch->config.read_increment ? i : 0];
+        pio_sm_put_blocking(pio0, 0, ch->config.bswap ? __builtin_bswap32(word) : word);
+    }
+}
+
+// Walks a display list: the control channel loads {count, address} blocks
+// into the data channel, which feeds the PIO TX FIFO.
+static void host_dma_run_list(const host_dl_block_t *block, const host_dma_channel_t *data)
+{
+    for (; block->count != 0; block++)
+    {
+        const uint32_t *words = block->addr;
+        for (uint32_t i = 0; i < block->count; i++)
+        {
+            uint32_t word = data->config.bswap ? __builtin_bswap32(words[i]) : words[i];
+            pio_sm_put_blocking(pio0, 0, word);
+        }
+    }
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+    host_dma_channel_t *ch = &_dma[channel];
+    ch->config = *config;
+    ch->write_addr = write_addr;
+    ch->read_addr = read_addr;
+    if (!trigger)
+    {
+        return;
+    }
+    if (write_addr == &pio0->txf[0] || write_addr == &pio1->txf[0])
+    {
+        host_dma_run_pio(ch, transfer_count);
+        return;
+    }
+    host_dma_run_spi(ch, transfer_count);
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger)
+{
+    host_dma_channel_t *ch = &_dma[channel];
+    ch->read_addr = read_addr;
+    if (!trigger || !ch->config.ring)
+    {
+        return;
+    }
+    // The control channel writes into the data channel's registers
+    for (int i = 0; i < _dma_claimed; i++)
+    {
+        if (ch->write_addr == &_dma[i].hw.al3_transfer_count)
+        {
+            host_dma_run_list((const host_dl_block_t *)read_addr, &_dma[i]);
+            return;
+        }
+    }
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    (void)channel;
+    return false;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel)
+{
+    (void)channel;
+}
+
+dma_channel_hw_t *dma_channel_hw_addr(uint channel)
+{
+    return &_dma[channel].hw;
+}
+
+// ---- Multicore ----
+
+static __thread uint _core_num = 0;
+static pthread_t _core1;
+static void (*_core1_entry)(void);
+
+static pthread_mutex_t _fifo_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _fifo_changed = PTHREAD_COND_INITIALIZER;
+static uint32_t _fifo[4];
+static unsigned _fifo_head, _fifo_tail;
+
+uint get_core_num(void)
+{
+    return _core_num;
+}
+
+static void *host_core1_main(void *arg)
+{
+    (void)arg;
+    _core_num = 1;
+    _core1_entry();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entry)(void))
+{
+    _core1_entry = entry;
+    pthread_create(&_core1, NULL, host_core1_main, NULL);
+    pthread_detach(_core1);
+}
+
+void multicore_fifo_push_blocking(uint32_t data)
+{
+    pthread_mutex_lock(&_fifo_lock);
+    while (_fifo_tail - _fifo_head == 4)
+    {
+        pthread_cond_wait(&_fifo_changed, &_fifo_lock);
+    }
+    _fifo[_fifo_tail++ % 4] = data;
+    pthread_cond_broadcast(&_fifo_changed);
+    pthread_mutex_unlock(&_fifo_lock);
+}
+
+uint32_t multicore_fifo_pop_blocking(void)
+{
+    pthread_mutex_lock(&_fifo_lock);
+    while (_fifo_tail == _fifo_head)
+    {
+        pthread_cond_wait(&_fifo_changed, &_fifo_lock);
+    }
+    uint32_t data = _fifo[_fifo_head++ % 4];
+    pthread_cond_broadcast(&_fifo_changed);
+    pthread_mutex_unlock(&_fifo_lock);
+    return data;
+}
@@ -0,0 +1,235 @@
+// Records and replays runs in the game/replay.h format. A recording is a
+// seed plus the input of every tick; replaying it must end on the same
+// game_state_hash() as the run that made it, on the board or here.
+//
+//   st7735_replay -w out.rep [-n ticks] [-s seed]   record a scripted run
+//   st7735_replay [-r every] [-o out.ppm] in.rep     replay a recording
+//
+// The input file is either the binary stream or a UART log containing the
+// board's "REPLAY <hex>" lines. With -r the game is also rendered every
+// that many ticks, and the final screen can be dumped as PPM.
+#include "game/game.h"
+#include "game/gamestate.h"
+#include "game/replay.h"
+#include "hal/displays/st7735.h"
+#include "pico_host.h"
+#include "st7735_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_STREAM (1 << 20)
+
+static uint8_t _stream[MAX_STREAM];
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int hex_digit(int c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Binary stream as is, or the hex payload of every "REPLAY " line
+static size_t load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        return 0;
+    }
+    size_t len = fread(_stream, 1, MAX_STREAM, f);
+    fclose(f);
+    if (len >= 4 && memcmp(_stream, "SIR1", 4) == 0)
+    {
+        return len;
+    }
+
+    static char text[MAX_STREAM + 1];
+    memcpy(text, _stream, len);
+    text[len] = '\0';
+    size_t out = 0;
+    for (char *line = strstr(text, "REPLAY "); line; line = strstr(line, "REPLAY "))
+    {
+        line += 7;
+        while (hex_digit(line[0]) >= 0 && hex_digit(line[1]) >= 0)
+        {
+            _stream[out++] = (uint8_t)(hex_digit(line[0]) << 4 | hex_digit(line[1]));
+            line += 2;
+        }
+    }
+    return out;
+}
+
+// Deterministic stand-in for a player: starts the game, sweeps at varying
+// stick deflections and fires in bursts; restarts after a game over
+static void scripted_input(uint32_t tick, int8_t *move, bool *fire)
+{
+    if (get_state() != GAMESTATE_PLAYING)
+    {
+        *move = -127;
+        *fire = false;
+        return;
+    }
+    static const int8_t sweep[] = {127, 90, 40, -40, -90, -127, -64, 0};
+    *move = sweep[(tick / 60) % 8];
+    *fire = (tick / 10) % 3 != 0;
+}
+
+static int record(const char *path, uint32_t ticks, uint32_t seed)
+{
+    replay_record_start(_stream, sizeof(_stream), seed);
+    game_seed(seed);
+    game_reset();
+    for (uint32_t t = 0; t < ticks; t++)
+    {
+        int8_t move;
+        bool fire;
+        scripted_input(t, &move, &fire);
+        replay_record_tick(move, fire);
+        game_tick(replay_move(move), fire);
+        pico_host_advance_us(GAME_TICK_US);
+    }
+    uint32_t hash = game_state_hash();
+    size_t len = replay_record_finish(hash);
+    if (len == 0)
+    {
+        fprintf(stderr, "recording does not fit\n");
+        return 1;
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f || fwrite(_stream, 1, len, f) != len)
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
+    }
+    fclose(f);
+    printf("recorded %u ticks, seed %08x, %zu bytes, state %08x\n", ticks, seed, len, hash);
+    return 0;
+}
+
+static int play(const char *path, int render_every, const char *ppm)
+{
+    size_t len = load(path);
+    uint32_t seed;
+    if (len == 0 || !replay_play_start(_stream, len, &seed))
+    {
+        fprintf(stderr, "%s: no replay stream\n", path);
+        return 1;
+    }
+    uint32_t expected_ticks, expected_hash;
+    bool has_footer = replay_expected(&expected_ticks, &expected_hash);
+
+    game_seed(seed);
+    game_reset();
+    st7735_host_reset_stats();
+
+    uint32_t ticks = 0;
+    uint32_t frames = 0;
+    int8_t move;
+    bool fire;
+    uint64_t start = host_now_ns();
+    while (replay_play_tick(&move, &fire))
+    {
+        game_tick(replay_move(move), fire);
+        pico_host_advance_us(GAME_TICK_US);
+        ticks++;
+        if (render_every > 0 && ticks % render_every == 0)
+        {
+            game_render();
+            frames++;
+        }
+    }
+    double cpu_ms = (host_now_ns() - start) / 1e6;
+    uint32_t hash = game_state_hash();
+
+    printf("seed %08x, %u ticks, state %08x", seed, ticks, hash);
+    if (has_footer)
+    {
+        bool ok = hash == expected_hash && ticks == expected_ticks;
+        printf(" (%s)", ok ? "OK" : "MISMATCH");
+    }
+    printf(", %.1f ms cpu\n", cpu_ms);
+
+    if (frames > 0)
+    {
+        st7735_wait();
+        st7735_host_stats_t stats;
+        st7735_host_get_stats(&stats);
+        printf("%u frames, surface %08x, %llu bytes/frame\n", frames, (unsigned)st7735_host_surface_hash(),
+               (unsigned long long)(stats.bytes / frames));
+        if (ppm && !st7735_host_dump_ppm(ppm))
+        {
+            fprintf(stderr, "cannot write %s\n", ppm);
+            return 1;
+        }
+    }
+    return has_footer && (hash != expected_hash || ticks != expected_ticks) ? 1 : 0;
+}
+
+static int usage(const char *name)
+{
+    fprintf(stderr, "usage: %s -w out.rep [-n ticks] [-s seed]\n"
+                    "       %s [-r every] [-o out.ppm] in.rep\n",
+            name, name);
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    const char *out = NULL;
+    const char *ppm = NULL;
+    uint32_t ticks = 120 * 60;
+    uint32_t seed = 1;
+    int render_every = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:n:s:r:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'w':
+            out = optarg;
+            break;
+        case 'n':
+            ticks = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            render_every = atoi(optarg);
+            break;
+        case 'o':
+            ppm = optarg;
+            break;
+        default:
+            return usage(argv[0]);
+        }
+    }
+    if (!out && optind != argc - 1)
+    {
+        return usage(argv[0]);
+    }
+
+    game_init();
+    return out ? record(out, ticks, seed) : play(argv[optind], render_every, ppm);
+}
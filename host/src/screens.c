@@ -0,0 +1,144 @@
+// Renders the menu, gameplay and game-over screens through the real driver
+// on the simulated panel. Dumps each one as PPM, optionally compares them
+// with golden images, and reports bus traffic for the chosen render mode.
+//
+//   st7735_screens [-m dirty|full|strip] [-o out_dir] [-g golden_dir] [-n frames]
+#include "game/game.h"
+#include "game/gamestate.h"
+#include "hal/displays/st7735.h"
+#include "pico_host.h"
+#include "st7735_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FRAME_US 50000 // game time covered by each captured frame
+
+static const char *_mode = "dirty";
+static const char *_out_dir = ".";
+static const char *_golden_dir = NULL;
+static int _failures = 0;
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Applies the render mode on top of the configuration game_init() sets up.
+static void apply_mode(void)
+{
+    if (strcmp(_mode, "full") == 0)
+    {
+        st7735_set_dirty_tracking(false);
+    }
+    else if (strcmp(_mode, "strip") == 0)
+    {
+        st7735_set_strip_mode(true);
+    }
+}
+
+static void capture(const char *name, int frames, uint64_t cpu_ns)
+{
+    st7735_wait();
+
+    st7735_host_stats_t stats;
+    st7735_host_get_stats(&stats);
+    st7735_host_reset_stats();
+    if (frames < 1)
+    {
+        frames = 1;
+    }
+    printf("%-10s %08x %8llu %7u %6u %8.1f\n", name, (unsigned)st7735_host_surface_hash(),
+           (unsigned long long)(stats.bytes / frames), stats.windows / frames, stats.transactions / frames,
+           cpu_ns / 1000.0 / frames);
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.ppm", _out_dir, name);
+    if (!st7735_host_dump_ppm(path))
+    {
+        fprintf(stderr, "cannot write %s\n", path);
+        _failures++;
+    }
+
+    if (_golden_dir)
+    {
+        snprintf(path, sizeof(path), "%s/%s.ppm", _golden_dir, name);
+        int mismatches = st7735_host_compare_ppm(path);
+        if (mismatches != 0)
+        {
+            fprintf(stderr, "%s: %s\n", name, mismatches < 0 ? "no golden image" : "differs from golden image");
+            if (mismatches > 0)
+            {
+                fprintf(stderr, "%s: %d pixels differ\n", name, mismatches);
+            }
+            _failures++;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int frames = 100;
+    int opt;
+    while ((opt = getopt(argc, argv, "m:o:g:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm':
+            _mode = optarg;
+            break;
+        case 'o':
+            _out_dir = optarg;
+            break;
+        case 'g':
+            _golden_dir = optarg;
+            break;
+        case 'n':
+            frames = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-m dirty|full|strip] [-o out_dir] [-g golden_dir] [-n frames]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("mode %s, per frame:\n", _mode);
+    printf("%-10s %8s %8s %7s %6s %8s\n", "screen", "hash", "bytes", "windows", "cs", "cpu_us");
+
+    game_init();
+    apply_mode();
+    st7735_host_reset_stats();
+
+    uint64_t start = host_now_ns();
+    game_render();
+    capture("menu", 1, host_now_ns() - start);
+
+    // LEFT starts the game; then sweep left and right while firing
+    game_tick(-FIX16_ONE, 0);
+    pico_host_advance_us(GAME_TICK_US);
+    st7735_wait();
+    st7735_host_reset_stats();
+    start = host_now_ns();
+    for (int i = 0; i < frames && get_state() == GAMESTATE_PLAYING; i++)
+    {
+        int move = ((i / 16) % 2) ? -1 : 1;
+        for (int t = 0; t < FRAME_US / GAME_TICK_US; t++)
+        {
+            game_tick(fix16_from_int(move), i % 3 == 0);
+            pico_host_advance_us(GAME_TICK_US);
+        }
+        game_render();
+    }
+    capture("gameplay", frames, host_now_ns() - start);
+
+    set_state(GAMESTATE_GAME_OVER);
+    start = host_now_ns();
+    game_render();
+    capture("game_over", 1, host_now_ns() - start);
+
+    return _failures ? 1 : 0;
+}
@@ -0,0 +1,310 @@
+// Shield cost per tick under heavy fire (game/shields.h): shots cross the
+// shield band up and down every tick and erode the bunkers until they are
+// gone, then the shields are restored. The word-per-row hit test runs
+// against a reference that tests and erodes pixel by pixel; both must end
+// in the same bitmaps. Also times building the shield tiles for a frame
+// and counts the bytes the tagged tiles resend compared with redrawing
+// every shield.
+//
+//   shield_bench [-t ticks]
+#include "game/game.h"
+#include "game/shields.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHOT_W 2
+#define SHOT_H 6
+#define MAX_SHOTS 128
+
+typedef struct
+{
+    int x, y, dir;
+} shot_t;
+
+static shot_t _shots[MAX_SHOTS];
+static int _band_x, _band_y, _band_w, _band_h;
+
+// ---- Per-pixel reference ----
+
+static const char *_shape[SHIELD_H] = {
+    "....XXXXXXXXXXXXXX....", "...XXXXXXXXXXXXXXXX...", "..XXXXXXXXXXXXXXXXXX..", ".XXXXXXXXXXXXXXXXXXXX.",
+    "XXXXXXXXXXXXXXXXXXXXXX", "XXXXXXXXXXXXXXXXXXXXXX", "XXXXXXXXXXXXXXXXXXXXXX", "XXXXXXXXXXXXXXXXXXXXXX",
+    "XXXXXXX........XXXXXXX", "XXXXXX..........XXXXXX", "XXXXX............XXXXX", "XXXXX............XXXXX",
+};
+
+static const char *_crater[5] = {".X.X.X.", ".XXXXX.", "XXXXXXX", ".XXXXX.", "X.X.X.."};
+
+static bool _pixels[SHIELD_COUNT][SHIELD_H][SHIELD_W];
+
+static int ref_shield_x(int s)
+{
+    return _band_x + s * ((_band_w - SHIELD_W) / (SHIELD_COUNT - 1));
+}
+
+static void ref_init(void)
+{
+    for (int s = 0; s < SHIELD_COUNT; s++)
+    {
+        for (int r = 0; r < SHIELD_H; r++)
+        {
+            for (int c = 0; c < SHIELD_W; c++)
+            {
+                _pixels[s][r][c] = _shape[r][c] == 'X';
+            }
+        }
+    }
+}
+
+static bool ref_hit(int x, int y, int w, int h, int dir)
+{
+    for (int s = 0; s < SHIELD_COUNT; s++)
+    {
+        int dx = x - ref_shield_x(s);
+        for (int i = 0; i < h; i++)
+        {
+            int r = (dir < 0 ? y + h - 1 - i : y + i) - SHIELD_Y;
+            if (r < 0 || r >= SHIELD_H)
+            {
+                continue;
+            }
+            for (int c = dx; c < dx + w; c++)
+            {
+                if (c < 0 || c >= SHIELD_W || !_pixels[s][r][c])
+                {
+                    continue;
+                }
+                for (int cr = 0; cr < 5; cr++)
+                {
+                    for (int cc = 0; cc < 7; cc++)
+                    {
+                        int pr = r + cr - 2;
+                        int pc = c + cc - 3;
+                        if (_crater[cr][cc] == 'X' && pr >= 0 && pr < SHIELD_H && pc >= 0 && pc < SHIELD_W)
+                        {
+                            _pixels[s][pr][pc] = false;
+                        }
+                    }
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Packs the pixels the way shields.c stores them so the hashes compare
+static uint32_t ref_hash(void)
+{
+    uint32_t rows[SHIELD_COUNT][SHIELD_H] = {{0}};
+    for (int s = 0; s < SHIELD_COUNT; s++)
+    {
+        for (int r = 0; r < SHIELD_H; r++)
+        {
+            for (int c = 0; c < SHIELD_W; c++)
+            {
+                rows[s][r] |= (uint32_t)_pixels[s][r][c] << (31 - c);
+            }
+        }
+    }
+    return game_hash(GAME_HASH_INIT, rows, sizeof(rows));
+}
+
+// ---- Harness ----
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Half the shots climb from below the band, half fall from above it, at
+// random columns over the whole band, a few pixels per tick
+static void spawn(shot_t *s, int i)
+{
+    s->x = _band_x - SHOT_W + rand() % (_band_w + SHOT_W);
+    s->dir = i & 1 ? 1 : -1;
+    s->y = s->dir < 0 ? _band_y + _band_h + rand() % 8 : _band_y - SHOT_H - rand() % 8;
+}
+
+static void advance(int n, const bool *used)
+{
+    for (int i = 0; i < n; i++)
+    {
+        _shots[i].y += _shots[i].dir * 2;
+        if (used[i] || _shots[i].y < _band_y - SHOT_H - 8 || _shots[i].y > _band_y + _band_h + 8)
+        {
+            spawn(&_shots[i], i);
+        }
+    }
+}
+
+static void bench(int n, int ticks)
+{
+    static bool used[MAX_SHOTS];
+    uint32_t word_hits = 0, ref_hits = 0;
+    bool same = true;
+
+    // Word-parallel, as game.c runs it
+    srand(n);
+    for (int i = 0; i < n; i++)
+    {
+        spawn(&_shots[i], i);
+    }
+    shields_init();
+    uint64_t word_ns = 0;
+    for (int t = 0; t < ticks; t++)
+    {
+        uint64_t start = host_now_ns();
+        for (int i = 0; i < n; i++)
+        {
+            used[i] = shields_hit(_shots[i].x, _shots[i].y, SHOT_W, SHOT_H, _shots[i].dir);
+        }
+        word_ns += host_now_ns() - start;
+        for (int i = 0; i < n; i++)
+        {
+            word_hits += used[i];
+        }
+        advance(n, used);
+        if (t % 256 == 255)
+        {
+            shields_init();
+        }
+    }
+    uint32_t word_hash = shields_state_hash(GAME_HASH_INIT);
+
+    // Same shots against the per-pixel reference
+    srand(n);
+    for (int i = 0; i < n; i++)
+    {
+        spawn(&_shots[i], i);
+    }
+    ref_init();
+    uint64_t ref_ns = 0;
+    for (int t = 0; t < ticks; t++)
+    {
+        uint64_t start = host_now_ns();
+        for (int i = 0; i < n; i++)
+        {
+            used[i] = ref_hit(_shots[i].x, _shots[i].y, SHOT_W, SHOT_H, _shots[i].dir);
+        }
+        ref_ns += host_now_ns() - start;
+        for (int i = 0; i < n; i++)
+        {
+            ref_hits += used[i];
+        }
+        advance(n, used);
+        if (t % 256 == 255)
+        {
+            ref_init();
+        }
+    }
+    same = word_hits == ref_hits && word_hash == ref_hash();
+
+    printf("%5d %10.3f %10.3f %8.1fx %8.1f   %s\n", n, word_ns / 1000.0 / ticks, ref_ns / 1000.0 / ticks,
+           (double)ref_ns / word_ns, (double)word_hits / ticks, same ? "same" : "DIFFERENT");
+}
+
+// Tiles whose rect and tag match the previous frame are skipped by the
+// driver; count what is left, as pixels of RGB565
+static uint32_t changed_bytes(const render_frame_t *prev, const render_frame_t *cur)
+{
+    uint32_t bytes = 0;
+    for (int i = 0; i < cur->count; i++)
+    {
+        const render_command_t *c = &cur->commands[i];
+        bool kept = false;
+        for (int j = 0; j < prev->count && !kept; j++)
+        {
+            const render_command_t *p = &prev->commands[j];
+            kept = p->x == c->x && p->y == c->y && p->w == c->w && p->h == c->h && p->tag == c->tag;
+        }
+        if (!kept)
+        {
+            bytes += (uint32_t)c->w * c->h * 2;
+        }
+    }
+    return bytes;
+}
+
+static void bench_draw(int n, int ticks)
+{
+    static render_frame_t frames[2];
+    static bool used[MAX_SHOTS];
+    srand(n);
+    for (int i = 0; i < n; i++)
+    {
+        spawn(&_shots[i], i);
+    }
+    shields_init();
+    frames[0].count = frames[0].tile_count = 0;
+    shields_draw(&frames[0]);
+
+    uint64_t draw_ns = 0;
+    uint64_t bytes = 0;
+    uint32_t hit_ticks = 0;
+    for (int t = 0; t < ticks; t++)
+    {
+        bool hit = false;
+        for (int i = 0; i < n; i++)
+        {
+            used[i] = shields_hit(_shots[i].x, _shots[i].y, SHOT_W, SHOT_H, _shots[i].dir);
+            hit |= used[i];
+        }
+        advance(n, used);
+        if (t % 256 == 255)
+        {
+            shields_init();
+        }
+
+        render_frame_t *prev = &frames[t & 1];
+        render_frame_t *cur = &frames[(t + 1) & 1];
+        uint64_t start = host_now_ns();
+        cur->count = cur->tile_count = 0;
+        shields_draw(cur);
+        draw_ns += host_now_ns() - start;
+        bytes += changed_bytes(prev, cur);
+        hit_ticks += hit;
+    }
+
+    uint32_t full = SHIELD_COUNT * SHIELD_W * SHIELD_H * 2;
+    printf("%5d %10.3f %10.1f %10u %10.1f%%\n", n, draw_ns / 1000.0 / ticks, (double)bytes / ticks, full,
+           100.0 * hit_ticks / ticks);
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = 20000;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t ticks]\n", argv[0]);
+            return 2;
+        }
+    }
+    shields_get_bounds(&_band_x, &_band_y, &_band_w, &_band_h);
+
+    printf("Hit tests, us per tick, %d ticks, %d shields restored every 256 ticks\n", ticks, SHIELD_COUNT);
+    printf("%5s %10s %10s %9s %8s   %s\n", "shots", "words", "pixels", "speedup", "hits", "bitmaps");
+    for (int n = 8; n <= MAX_SHOTS; n *= 2)
+    {
+        bench(n, ticks);
+    }
+
+    printf("\nTiles, us per frame to build; bytes per frame resent against a full redraw\n");
+    printf("%5s %10s %10s %10s %11s\n", "shots", "build", "resent", "full", "ticks hit");
+    for (int n = 8; n <= MAX_SHOTS; n *= 2)
+    {
+        bench_draw(n, ticks);
+    }
+    return 0;
+}
@@ -0,0 +1,190 @@
+// Picking the invader that fires: up to 10 random cells until one is
+// alive, as enemies.c did, against the per-column table in formation_t
+// (formation_shooter()). Run on the 5x11 formation as it thins out, with
+// the cost per pick, how often the old way found nobody or fired through
+// an invader below, and how evenly the table spreads shots over the
+// non-empty columns. The table is also checked against a full scan.
+//
+//   shooter_bench [-p picks]
+#include "game/formation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ROWS 5
+#define COLS 11
+
+static uint32_t _rng = 1;
+
+static uint32_t next_rand(void)
+{
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+}
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// The previous selection: any alive cell, so it may sit above another
+static int tries_pick(const formation_t *f)
+{
+    for (int tries = 0; tries < 10; tries++)
+    {
+        int i = (int)(next_rand() % (f->rows * f->cols));
+        if (formation_alive(f, i / f->cols, i % f->cols))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static bool has_alive_below(const formation_t *f, int row, int col)
+{
+    for (int r = row + 1; r < f->rows; r++)
+    {
+        if (formation_alive(f, r, col))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Compares bottom[] and the column list with a scan of the alive masks
+static bool table_consistent(const formation_t *f)
+{
+    int listed = 0;
+    for (int c = 0; c < f->cols; c++)
+    {
+        int bottom = -1;
+        for (int r = 0; r < f->rows; r++)
+        {
+            if (formation_alive(f, r, c))
+            {
+                bottom = r;
+            }
+        }
+        if (f->bottom[c] != bottom)
+        {
+            return false;
+        }
+        if (bottom >= 0)
+        {
+            listed++;
+            if (f->column_list[f->column_slot[c]] != c)
+            {
+                return false;
+            }
+        }
+    }
+    return listed == f->column_count;
+}
+
+static void bench(int alive, int picks)
+{
+    static formation_t f;
+    formation_init(&f, ROWS, COLS, 4, 18, 11, 12, 10, 8);
+    _rng = 12345;
+    while (f.alive_count > alive)
+    {
+        int i = (int)(next_rand() % (ROWS * COLS));
+        formation_kill(&f, i / COLS, i % COLS);
+    }
+    bool consistent = table_consistent(&f);
+
+    volatile int sink = 0;
+    int missed = 0, through = 0;
+    uint64_t start = host_now_ns();
+    for (int p = 0; p < picks; p++)
+    {
+        sink += tries_pick(&f);
+    }
+    double tries_ns = (double)(host_now_ns() - start) / picks;
+
+    _rng = 777;
+    for (int p = 0; p < picks; p++)
+    {
+        int i = tries_pick(&f);
+        if (i < 0)
+        {
+            missed++;
+        }
+        else if (has_alive_below(&f, i / COLS, i % COLS))
+        {
+            through++;
+        }
+    }
+
+    start = host_now_ns();
+    for (int p = 0; p < picks; p++)
+    {
+        int row, col;
+        if (formation_shooter(&f, next_rand(), &row, &col))
+        {
+            sink += row + col;
+        }
+    }
+    double table_ns = (double)(host_now_ns() - start) / picks;
+
+    // Shots per column: worst deviation from an even share
+    int per_col[COLS] = {0};
+    for (int p = 0; p < picks; p++)
+    {
+        int row, col;
+        if (formation_shooter(&f, next_rand(), &row, &col))
+        {
+            per_col[col]++;
+        }
+    }
+    double expected = (double)picks / f.column_count;
+    double worst = 0;
+    for (int c = 0; c < COLS; c++)
+    {
+        if (f.bottom[c] >= 0)
+        {
+            double dev = (per_col[c] > expected ? per_col[c] - expected : expected - per_col[c]) / expected;
+            worst = dev > worst ? dev : worst;
+        }
+    }
+
+    printf("%5d %4d %8.1f %8.1f %7.2f%% %7.2f%% %8.2f%%   %s\n", alive, f.column_count, tries_ns, table_ns,
+           100.0 * missed / picks, 100.0 * through / picks, 100.0 * worst, consistent ? "ok" : "WRONG");
+}
+
+int main(int argc, char **argv)
+{
+    int picks = 1000000;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            picks = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-p picks]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("%dx%d formation, %d picks; ns per pick, old misses and shots through an invader below,\n"
+           "worst deviation of the table's per-column share from an even split\n",
+           ROWS, COLS, picks);
+    printf("%5s %4s %8s %8s %8s %8s %9s   %s\n", "alive", "cols", "tries", "table", "missed", "through",
+           "unfair", "table");
+    static const int alive[] = {55, 40, 28, 14, 7, 3, 1};
+    for (unsigned i = 0; i < sizeof(alive) / sizeof(alive[0]); i++)
+    {
+        bench(alive[i], picks);
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "st7735_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ST7735_CASET 0x2A
+#define ST7735_RASET 0x2B
+#define ST7735_RAMWR 0x2C
+
+static unsigned _cs_pin = 17;
+static unsigned _dc_pin = 3;
+static bool _cs = true; // idle high
+static bool _dc = true;
+
+static uint16_t _surface[ST7735_HOST_HEIGHT * ST7735_HOST_WIDTH];
+static st7735_host_stats_t _stats;
+
+// Command decoder state
+static int _cmd = -1;
+static uint8_t _args[4];
+static int _arg_count;
+static int _x0, _x1, _y0, _y1; // address window
+static int _x, _y;             // write position inside it
+static int _high = -1;         // first byte of a pixel
+
+void st7735_host_set_pins(unsigned cs_pin, unsigned dc_pin)
+{
+    _cs_pin = cs_pin;
+    _dc_pin = dc_pin;
+}
+
+const uint16_t *st7735_host_surface(void)
+{
+    return _surface;
+}
+
+uint32_t st7735_host_surface_hash(void)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(_surface) / sizeof(_surface[0]); i++)
+    {
+        hash = (hash ^ _surface[i]) * 16777619u;
+    }
+    return hash;
+}
+
+void st7735_host_get_stats(st7735_host_stats_t *stats)
+{
+    *stats = _stats;
+}
+
+void st7735_host_reset_stats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+static void st7735_host_byte(bool dc, uint8_t byte)
+{
+    _stats.bytes++;
+    if (!dc)
+    {
+        _stats.commands++;
+        _cmd = byte;
+        _arg_count = 0;
+        if (byte == ST7735_RAMWR)
+        {
+            _stats.windows++;
+            _x = _x0;
+            _y = _y0;
+            _high = -1;
+        }
+        return;
+    }
+
+    if (_cmd == ST7735_CASET || _cmd == ST7735_RASET)
+    {
+        if (_arg_count < 4)
+        {
+            _args[_arg_count++] = byte;
+        }
+        if (_arg_count == 4)
+        {
+            int start = (_args[0] << 8) | _args[1];
+            int end = (_args[2] << 8) | _args[3];
+            if (_cmd == ST7735_CASET)
+            {
+                _x0 = start;
+                _x1 = end;
+            }
+            else
+            {
+                _y0 = start;
+                _y1 = end;
+            }
+        }
+        return;
+    }
+
+    if (_cmd == ST7735_RAMWR)
+    {
+        if (_high < 0)
+        {
+            _high = byte;
+            return;
+        }
+        if (_y <= _y1 && _x < ST7735_HOST_WIDTH && _y < ST7735_HOST_HEIGHT)
+        {
+            _surface[_y * ST7735_HOST_WIDTH + _x] = (uint16_t)((_high << 8) | byte);
+        }
+        _high = -1;
+        if (++_x > _x1)
+        {
+            _x = _x0;
+            _y++;
+        }
+    }
+}
+
+void st7735_host_gpio(unsigned pin, bool value)
+{
+    if (pin == _cs_pin)
+    {
+        if (_cs && !value)
+        {
+            _stats.transactions++;
+        }
+        _cs = value;
+    }
+    else if (pin == _dc_pin)
+    {
+        _dc = value;
+    }
+}
+
+void st7735_host_spi_byte(uint8_t byte)
+{
+    if (_cs)
+    {
+        // The panel ignores the bus while CS is high; so does the model
+        fprintf(stderr, "st7735_host: byte 0x%02x sent with CS high\n", byte);
+        return;
+    }
+    st7735_host_byte(_dc, byte);
+}
+
+void st7735_host_frame_byte(bool dc, uint8_t byte)
+{
+    st7735_host_byte(dc, byte);
+}
+
+static void st7735_host_rgb(uint16_t pixel, uint8_t rgb[3])
+{
+    rgb[0] = (uint8_t)(((pixel >> 11) & 0x1F) * 255 / 31);
+    rgb[1] = (uint8_t)(((pixel >> 5) & 0x3F) * 255 / 63);
+    rgb[2] = (uint8_t)((pixel & 0x1F) * 255 / 31);
+}
+
+bool st7735_host_dump_ppm(const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        return false;
+    }
+    fprintf(f, "P6\n%d %d\n255\n", ST7735_HOST_WIDTH, ST7735_HOST_HEIGHT);
+    for (int i = 0; i < ST7735_HOST_WIDTH * ST7735_HOST_HEIGHT; i++)
+    {
+        uint8_t rgb[3];
+        st7735_host_rgb(_surface[i], rgb);
+        fwrite(rgb, 1, 3, f);
+    }
+    return fclose(f) == 0;
+}
+
+int st7735_host_compare_ppm(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        return -1;
+    }
+    int w, h, max;
+    if (fscanf(f, "P6 %d %d %d", &w, &h, &max) != 3 || w != ST7735_HOST_WIDTH || h != ST7735_HOST_HEIGHT ||
+        max != 255 || fgetc(f) == EOF)
+    {
+        fclose(f);
+        return -1;
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < ST7735_HOST_WIDTH * ST7735_HOST_HEIGHT; i++)
+    {
+        uint8_t expected[3], actual[3];
+        if (fread(expected, 1, 3, f) != 3)
+        {
+            fclose(f);
+            return -1;
+        }
+        st7735_host_rgb(_surface[i], actual);
+        if (memcmp(expected, actual, 3) != 0)
+        {
+            mismatches++;
+        }
+    }
+    fclose(f);
+    return mismatches;
+}
@@ -0,0 +1,139 @@
+// Cost of each wave in the table (game/waves.h): the whole game runs with
+// a scripted player that sweeps and fires, one wave at a time, rendering
+// every tick, and the per-tick simulation and frame times are checked
+// against a budget. The largest wave is the one that has to fit.
+//
+// The budget is in host microseconds for tick + frame at p99; the default
+// is a tenth of the tick period, which leaves room for the board being an
+// order of magnitude slower than the host.
+//
+//   wave_bench [-t ticks] [-b budget_us]
+#include "game/game.h"
+#include "game/gamestate.h"
+#include "game/waves.h"
+#include "pico_host.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+static uint32_t *_tick_ns;
+static uint32_t *_frame_ns;
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static double p99_us(uint32_t *samples, int n)
+{
+    qsort(samples, n, sizeof(uint32_t), compare_u32);
+    return samples[(int)(0.99 * (n - 1) + 0.5)] / 1000.0;
+}
+
+// Plays wave n for the given ticks, restarting it after a game over and
+// when it is cleared, so every sample belongs to that wave
+static bool bench_wave(int n, int ticks, double budget_us)
+{
+    static render_frame_t frame;
+    int restarts = 0;
+    int cleared = 0;
+    uint64_t tick_sum = 0, frame_sum = 0;
+
+    game_reset();
+    game_tick(-FIX16_ONE, 0);
+    enemies_start_wave(n);
+    for (int t = 0; t < ticks; t++)
+    {
+        if (get_state() != GAMESTATE_PLAYING)
+        {
+            game_tick(-FIX16_ONE, 0); // game over: back to the menu, then start
+            game_tick(-FIX16_ONE, 0);
+            enemies_start_wave(n);
+            restarts++;
+        }
+        else if (enemies_wave() != n)
+        {
+            enemies_start_wave(n);
+            cleared++;
+        }
+
+        fix16_t move = ((t / 40) % 2) ? -FIX16_ONE : FIX16_ONE;
+        uint64_t start = host_now_ns();
+        game_tick(move, 1);
+        uint64_t ticked = host_now_ns();
+        game_build_frame(&frame);
+        game_draw_frame(&frame);
+        uint64_t drawn = host_now_ns();
+        pico_host_advance_us(GAME_TICK_US);
+
+        _tick_ns[t] = (uint32_t)(ticked - start);
+        _frame_ns[t] = (uint32_t)(drawn - ticked);
+        tick_sum += _tick_ns[t];
+        frame_sum += _frame_ns[t];
+    }
+
+    const wave_def_t *w = wave_get(n);
+    int size = 0;
+    for (int r = 0; r < w->rows; r++)
+    {
+        size += __builtin_popcount(w->shape[r] & ((1u << w->cols) - 1));
+    }
+    double tick_p99 = p99_us(_tick_ns, ticks);
+    double frame_p99 = p99_us(_frame_ns, ticks);
+    bool ok = tick_p99 + frame_p99 <= budget_us;
+    printf("%4d %5d %8.2f %8.2f %8.2f %8.2f %7d %8d   %s\n", n + 1, size, tick_sum / 1000.0 / ticks, tick_p99,
+           frame_sum / 1000.0 / ticks, frame_p99, cleared, restarts, ok ? "ok" : "OVER");
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    int ticks = 50000;
+    double budget_us = GAME_TICK_US / 10.0;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:b:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            ticks = atoi(optarg);
+            break;
+        case 'b':
+            budget_us = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t ticks] [-b budget_us]\n", argv[0]);
+            return 2;
+        }
+    }
+    _tick_ns = malloc(ticks * sizeof(uint32_t));
+    _frame_ns = malloc(ticks * sizeof(uint32_t));
+    if (ticks < 1 || !_tick_ns || !_frame_ns)
+    {
+        fprintf(stderr, "bad tick count\n");
+        return 2;
+    }
+
+    game_init();
+    game_seed(1);
+
+    printf("us per tick, %d ticks per wave, budget %.0f us for tick + frame at p99\n", ticks, budget_us);
+    printf("%4s %5s %8s %8s %8s %8s %7s %8s\n", "wave", "size", "tick", "p99", "frame", "p99", "cleared",
+           "restarts");
+    bool ok = true;
+    for (int n = 0; n < wave_count; n++)
+    {
+        ok &= bench_wave(n, ticks, budget_us);
+    }
+    return ok ? 0 : 1;
+}
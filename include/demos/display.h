@@ -1,8 +1,12 @@
 #ifndef DISPLAY_DEMO_H
 #define DISPLAY_DEMO_H
 
+#include <stdbool.h>
+
 void display_demo_execute(void);
 void display_draw_menu(void);
 void init_display(void);
+/* Panel on the PIO interface (st7735_use_pio); call after st7735_begin() */
+bool display_use_pio(void);
 
 #endif /* DISPLAY_DEMO_H */
\ No newline at end of file
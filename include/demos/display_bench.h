@@ -0,0 +1,6 @@
+#ifndef DISPLAY_BENCH_H
+#define DISPLAY_BENCH_H
+
+void display_bench_execute(void);
+
+#endif /* DISPLAY_BENCH_H */
@@ -0,0 +1,6 @@
+#ifndef FIXED_BENCH_H
+#define FIXED_BENCH_H
+
+void fixed_bench_execute(void);
+
+#endif /* FIXED_BENCH_H */
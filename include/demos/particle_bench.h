@@ -0,0 +1,6 @@
+#ifndef PARTICLE_BENCH_H
+#define PARTICLE_BENCH_H
+
+void particle_bench_execute(void);
+
+#endif /* PARTICLE_BENCH_H */
@@ -0,0 +1,65 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Sample mixer. The game asks for sounds with audio_play(), which only
+   queues a command and returns; audio_mix() runs wherever the output
+   wants samples (the PWM driver's DMA interrupt on the board, a WAV
+   writer on the host), takes the queued commands and mixes the channels
+   into signed 16-bit mono. One producer (the simulation) and one
+   consumer (the mixer), so the queue needs no lock and the game never
+   waits for audio. */
+#ifndef AUDIO_SAMPLE_RATE
+#define AUDIO_SAMPLE_RATE 22050
+#endif
+
+/* Longest buffer audio_mix() takes in one call */
+#define AUDIO_MAX_BUFFER 512
+
+/* Commands waiting for the mixer; more are dropped */
+#define AUDIO_QUEUE_DEPTH 16
+
+/* One sound at a time per channel; a new one replaces what is playing */
+typedef enum {
+    AUDIO_CH_SHOT,
+    AUDIO_CH_EXPLOSION,
+    AUDIO_CH_MARCH,   /* also the wave-cleared cue */
+    AUDIO_CH_EVENT,   /* the cannon hit */
+    AUDIO_CHANNELS
+} audio_channel_t;
+
+/* Playback rate factor, Q16.16 */
+#define AUDIO_PITCH_ONE 0x10000u
+
+/* Signed 8-bit PCM, const so it stays in flash */
+typedef struct {
+    const int8_t *data;
+    uint16_t length;   /* samples */
+    uint16_t rate;     /* Hz it plays at with AUDIO_PITCH_ONE */
+} audio_sample_t;
+
+typedef struct {
+    uint32_t buffers;  /* audio_mix() calls */
+    uint32_t played;   /* commands taken by the mixer */
+    uint32_t dropped;  /* commands lost to a full queue */
+    uint32_t clipped;  /* output samples limited to the 16-bit range */
+} audio_stats_t;
+
+/* Silence, empty queue, default master volume; call before the output starts */
+void audio_init(void);
+
+/* Queue sample on a channel at pitch (Q16.16) and volume (0..255). Never
+   blocks; false if the queue is full. NULL sample stops the channel. */
+bool audio_play(audio_channel_t channel, const audio_sample_t *sample, uint32_t pitch, uint8_t volume);
+
+/* Fill out with count samples (at most AUDIO_MAX_BUFFER) */
+void audio_mix(int16_t *out, int count);
+
+/* 0..256; 256 passes the channel sum through, lower leaves headroom */
+void audio_set_master(uint16_t volume);
+
+void audio_get_stats(audio_stats_t *stats);
+
+#endif /* AUDIO_H */
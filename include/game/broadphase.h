@@ -0,0 +1,61 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Uniform-grid broadphase over the 128x160 playfield. Boxes are rebuilt
+   every tick (clear, then insert what moved) and linked into each 16x16
+   cell they overlap; a query visits only the cells under its box, so its
+   cost follows the local density instead of the total entity count. */
+#define BROADPHASE_CELL_SHIFT 4
+#define BROADPHASE_COLS       (128 >> BROADPHASE_CELL_SHIFT)
+#define BROADPHASE_ROWS       (160 >> BROADPHASE_CELL_SHIFT)
+#define BROADPHASE_CELLS      (BROADPHASE_COLS * BROADPHASE_ROWS)
+
+#ifndef BROADPHASE_MAX_ENTRIES
+#define BROADPHASE_MAX_ENTRIES 128
+#endif
+/* Cell links; an entry no larger than a cell takes at most 4 */
+#define BROADPHASE_MAX_LINKS   (BROADPHASE_MAX_ENTRIES * 4)
+
+/* Layers, combined into a mask for queries */
+#define BROADPHASE_PLAYER_BULLET (1u << 0)
+#define BROADPHASE_ENEMY_BULLET  (1u << 1)
+#define BROADPHASE_ENEMY         (1u << 2)
+
+typedef struct {
+    int16_t x, y;
+    uint8_t w, h;
+    uint8_t layer;
+    uint16_t id;    /* caller's index, e.g. the bullet slot */
+    uint16_t stamp; /* last query that reported this entry */
+} broadphase_entry_t;
+
+typedef struct {
+    int16_t entry;
+    int16_t next;
+} broadphase_link_t;
+
+typedef struct {
+    int16_t head[BROADPHASE_CELLS];
+    broadphase_entry_t entries[BROADPHASE_MAX_ENTRIES];
+    broadphase_link_t links[BROADPHASE_MAX_LINKS];
+    uint16_t entry_count;
+    uint16_t link_count;
+    uint16_t stamp;
+} broadphase_t;
+
+void broadphase_clear(broadphase_t *grid);
+
+/* Add a box; false when the grid is full (the box is then not found) */
+bool broadphase_insert(broadphase_t *grid, int x, int y, int w, int h,
+                       uint8_t layer, uint16_t id);
+
+/* ids of the boxes on the given layers that overlap (x, y, w, h), each
+   reported once and in insertion order. Stores and returns at most
+   max_ids, the first in that order. */
+int broadphase_query(broadphase_t *grid, int x, int y, int w, int h,
+                     uint8_t layer_mask, uint16_t *ids, int max_ids);
+
+#endif /* BROADPHASE_H */
@@ -1,21 +1,36 @@
 #ifndef ENEMIES_H
 #define ENEMIES_H
 
+#include "game/broadphase.h"
+#include "game/render_queue.h"
 #include <stdbool.h>
+#include <stdint.h>
 
-/* Initialize enemies and enemy bullets */
+/* Start over at the first wave (game/waves.h) */
 void enemies_init(void);
 
-/* Update enemy positions and bullets */
-void enemies_update(void);
+/* Replace the current wave with wave n (0-based) on the next update */
+void enemies_start_wave(int n);
 
-/* Draw enemies and enemy bullets */
-void enemies_draw(void);
+/* Number of the current wave, 0-based */
+int enemies_wave(void);
 
-/* Check if a player bullet hits any enemy */
-void enemies_check_bullet_hits(int bullet_x, int bullet_y, bool* bullet_active);
+/* Move the formation and fire enemy shots for one game tick */
+void enemies_update(uint32_t tick);
 
-/* Check if player is hit by enemy bullets */
-bool enemies_check_player_hit(int player_x, int player_y, int player_width, int player_height);
+/* Draw commands for the enemies and enemy bullets */
+void enemies_draw(render_frame_t *frame);
+
+/* Fold the enemy state into a game_state_hash() */
+uint32_t enemies_state_hash(uint32_t h);
+
+/* Box around the alive enemies, for broadphase queries; false when none is left */
+bool enemies_get_bounds(int *x, int *y, int *w, int *h);
+
+/* Check if a player bullet hits any enemy (the enemy is removed and bursts into particles) */
+bool enemies_check_bullet_hits(int bullet_x, int bullet_y);
+
+/* Check if player is hit by enemy bullets found in the broadphase */
+bool enemies_check_player_hit(broadphase_t *grid, int player_x, int player_y, int player_width, int player_height);
 
 #endif /* ENEMIES_H */
@@ -0,0 +1,88 @@
+#ifndef ENTITIES_H
+#define ENTITIES_H
+
+#include "game/broadphase.h"
+#include "game/fixed.h"
+#include "hal/displays/st7735.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Entity store for everything that moves freely (the player, shots, and
+   later power-ups): one array per component, packed so that entities
+   0..count-1 are the live ones. Systems are single passes over those
+   arrays: entities_move() integrates and culls, entities_submit()
+   feeds the broadphase and entities_draw() emits draw commands.
+   A new kind of object is an entity_def_t, not a new set of loops.
+
+   Handles stay valid until the entity is destroyed; the dense position
+   of an entity changes whenever another one is destroyed. The invader
+   formation keeps its own bitmask store (formation.h). */
+#ifndef ENTITY_MAX
+#define ENTITY_MAX 64
+#endif
+
+typedef uint16_t entity_t;
+
+typedef struct render_frame render_frame_t; /* game/render_queue.h */
+#define ENTITY_NONE ((entity_t)0xFFFF)
+
+typedef enum {
+    ENTITY_PLAYER,
+    ENTITY_PLAYER_SHOT,
+    ENTITY_ENEMY_SHOT,
+    ENTITY_KINDS
+} entity_kind_t;
+
+/* Flags */
+#define ENTITY_CULL (1u << 0) /* destroyed once it leaves the screen */
+
+/* Everything an entity of one kind shares; usually const */
+typedef struct {
+    uint8_t kind;    /* entity_kind_t */
+    uint8_t w, h;
+    uint8_t layer;   /* broadphase layer, 0 = not collidable */
+    uint8_t flags;
+    uint16_t color;  /* filled rectangle, unless there is a sprite */
+    const st7735_sprite_t *sprite;
+} entity_def_t;
+
+typedef struct {
+    uint16_t capacity;
+    uint16_t active;
+    uint16_t high_water;         /* most entities alive at once */
+    uint16_t per_kind[ENTITY_KINDS];
+    uint32_t spawned;
+    uint32_t spawn_failed;       /* store was full */
+} entity_stats_t;
+
+void entities_init(void);
+
+/* New entity at (x, y) px moving at (vx, vy) px/s; ENTITY_NONE when full */
+entity_t entities_spawn(const entity_def_t *def, fix16_t x, fix16_t y, fix16_t vx, fix16_t vy);
+
+/* Does nothing for a handle that is already dead or ENTITY_NONE */
+void entities_destroy(entity_t e);
+
+/* Live entities of one kind (for per-kind limits) */
+int entities_count(entity_kind_t kind);
+
+/* False once e was destroyed (until its handle is reused) and for ENTITY_NONE */
+bool entities_alive(entity_t e);
+const entity_def_t *entities_def(entity_t e);
+
+fix16_t entities_x(entity_t e);
+fix16_t entities_y(entity_t e);
+void entities_set_x(entity_t e, fix16_t x);
+void entities_set_velocity(entity_t e, fix16_t vx, fix16_t vy);
+
+/* Systems */
+void entities_move(uint32_t dt_us);
+void entities_submit(broadphase_t *grid); /* id = handle */
+void entities_draw(render_frame_t *frame, entity_kind_t kind); /* appends draw commands */
+
+void entities_get_stats(entity_stats_t *stats);
+
+/* Fold positions, velocities and kinds into a game_state_hash() */
+uint32_t entities_state_hash(uint32_t h);
+
+#endif /* ENTITIES_H */
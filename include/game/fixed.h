@@ -0,0 +1,47 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+
+/* Q16.16 fixed point for sub-pixel positions and velocities: 16 integer
+   bits cover the playfield with room for off-screen values, 16 fraction
+   bits give 1/65536 px. Everything is integer add, shift and one
+   32x32->64 multiply, which the Cortex-M33 does in a single instruction. */
+typedef int32_t fix16_t;
+
+#define FIX16_SHIFT 16
+#define FIX16_ONE   ((fix16_t)1 << FIX16_SHIFT)
+
+/* Compile-time constants, e.g. FIX16(80) or FIX16(0.5) */
+#define FIX16(x) ((fix16_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+static inline fix16_t fix16_from_int(int v) {
+    return (fix16_t)v * FIX16_ONE;
+}
+
+/* Whole pixels, rounded towards minus infinity */
+static inline int fix16_to_int(fix16_t v) {
+    return (int)(v >> FIX16_SHIFT);
+}
+
+/* For input that arrives as float (joystick); not for per-entity math */
+static inline fix16_t fix16_from_float(float f) {
+    return (fix16_t)(f * 65536.0f);
+}
+
+static inline fix16_t fix16_mul(fix16_t a, fix16_t b) {
+    return (fix16_t)(((int64_t)a * b) >> FIX16_SHIFT);
+}
+
+static inline fix16_t fix16_clamp(fix16_t v, fix16_t lo, fix16_t hi) {
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+/* Distance covered in dt_us microseconds at velocity v (px/s), for fixed
+   or variable timesteps. Multiplies by 2^32 / 10^6 (4295, 0.001 % high)
+   instead of dividing by 10^6. Valid for |v| < 2^23 and dt_us < 2^20. */
+static inline fix16_t fix16_distance(fix16_t v, uint32_t dt_us) {
+    return (fix16_t)(((int64_t)v * dt_us * 4295) >> 32);
+}
+
+#endif /* FIXED_H */
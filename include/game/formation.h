@@ -0,0 +1,83 @@
+#ifndef FORMATION_H
+#define FORMATION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Invader formation as one origin plus an alive bitmask per row: bit c of
+   alive[r] is the invader in row r, column c. Moving the formation only
+   changes the origin, and a hit test is a division plus a bit test, so
+   the cost does not grow with the number of invaders. The pitches must
+   be larger than the hit box so neighbouring cells never overlap. */
+#define FORMATION_MAX_ROWS 8
+#define FORMATION_MAX_COLS 16
+
+typedef struct {
+    int x, y;                  /* top-left corner of row 0, column 0 */
+    uint8_t rows, cols;
+    uint8_t col_pitch;         /* distance between columns in px */
+    uint8_t row_pitch;         /* distance between rows in px */
+    uint8_t cell_w, cell_h;    /* invader hit box, inclusive like the old test */
+    uint16_t alive[FORMATION_MAX_ROWS];
+    uint16_t columns;          /* columns with at least one invader alive */
+    int8_t leftmost;           /* first/last alive column, -1 when empty */
+    int8_t rightmost;
+    uint16_t alive_count;
+    /* Shooters: lowest alive row per column (-1 when empty), and the
+       non-empty columns packed into a list; slot[c] is column c's index
+       in that list. Kept up to date by formation_kill(). */
+    int8_t bottom[FORMATION_MAX_COLS];
+    uint8_t column_list[FORMATION_MAX_COLS];
+    uint8_t column_slot[FORMATION_MAX_COLS];
+    uint8_t column_count;
+} formation_t;
+
+void formation_init(formation_t *f, int rows, int cols, int x, int y,
+                    int col_pitch, int row_pitch, int cell_w, int cell_h);
+
+/* Replace the full grid with one alive mask per row (bits beyond cols are
+   ignored), for formations that are not rectangles */
+void formation_set_shape(formation_t *f, const uint16_t *alive);
+
+static inline bool formation_alive(const formation_t *f, int row, int col) {
+    return (f->alive[row] >> col) & 1u;
+}
+
+/* Screen position of the cell in the given row/column */
+static inline int formation_cell_x(const formation_t *f, int col) {
+    return f->x + col * f->col_pitch;
+}
+
+static inline int formation_cell_y(const formation_t *f, int row) {
+    return f->y + row * f->row_pitch;
+}
+
+/* x of the leftmost and rightmost alive invader (undefined when empty) */
+static inline int formation_left(const formation_t *f) {
+    return formation_cell_x(f, f->leftmost);
+}
+
+static inline int formation_right(const formation_t *f) {
+    return formation_cell_x(f, f->rightmost);
+}
+
+/* Box around all alive invaders' hit boxes; false when none is left */
+bool formation_bounds(const formation_t *f, int *x, int *y, int *w, int *h);
+
+/* Remove one invader and refresh the cached column bounds */
+void formation_kill(formation_t *f, int row, int col);
+
+/* Invader covering point (px, py): kills it and returns true */
+bool formation_hit(formation_t *f, int px, int py);
+
+/* The invader allowed to fire for a random number r: the lowest one of
+   a non-empty column, every column equally likely. Nothing fires through
+   the invaders below it, and it only fails when the formation is empty. */
+static inline bool formation_shooter(const formation_t *f, uint32_t r, int *row, int *col) {
+    if (f->column_count == 0) return false;
+    *col = f->column_list[r % f->column_count];
+    *row = f->bottom[*col];
+    return true;
+}
+
+#endif /* FORMATION_H */
@@ -1,9 +1,68 @@
 #ifndef GAME_H
 #define GAME_H
 #include "game/enemies.h"
+#include "game/fixed.h"
+#include "game/render_queue.h"
+#include <stdint.h>
 
+/* Fixed simulation rate. All game logic advances in ticks of this length;
+   rendering runs separately at whatever rate the display can sustain. */
+#ifndef GAME_TICK_HZ
+#define GAME_TICK_HZ 120
+#endif
+#define GAME_TICK_US (1000000 / GAME_TICK_HZ)
+
+/* 1 = core 1 owns the display: handling_execute() only simulates on core 0
+   and queues render frames, so SPI transfers and drawing never delay a
+   tick. 0 = draw on core 0 and let the driver's pipelined mode flush on
+   core 1. */
+#ifndef GAME_DUAL_CORE
+#define GAME_DUAL_CORE 1
+#endif
+
+/* Milliseconds to ticks, rounded up */
+#define GAME_MS_TO_TICKS(ms) (((ms) * GAME_TICK_HZ + 999) / 1000)
+
+/* Display setup, a seed from the clock, then game_reset() */
 void game_init(void);
-void game_update(int move_dir, int fire);
-void draw_game_screen(void);
+
+/* Back to the menu with a fresh formation; keeps the random sequence */
+void game_reset(void);
+
+/* All game randomness comes from this generator, never from rand(), so
+   a seed plus the per-tick inputs replay identically on every platform */
+void game_seed(uint32_t seed);
+uint32_t game_rand(void);
+
+/* FNV-1a over everything the simulation depends on; equal hashes after
+   the same ticks mean the runs did not diverge */
+uint32_t game_state_hash(void);
+
+#define GAME_HASH_INIT 2166136261u
+
+static inline uint32_t game_hash(uint32_t h, const void *data, uint32_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len--) {
+        h ^= *p++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* Advance the simulation by one tick. move is the stick deflection in
+   Q16.16, -1.0 (full left) to 1.0 (full right), and scales the player's
+   speed; the menus react to a push of at least half way. */
+void game_tick(fix16_t move, int fire);
+
+/* Draw the current state (menu, playfield or game over):
+   game_build_frame() followed by game_draw_frame() */
+void game_render(void);
+
+/* Snapshot the current state as draw commands; touches no hardware */
+void game_build_frame(render_frame_t *frame);
+
+/* Put a frame on the display; the only game code that talks to it, so in
+   the dual-core build it runs on core 1 alone */
+void game_draw_frame(const render_frame_t *frame);
 
 #endif
@@ -1,6 +1,19 @@
 #ifndef HANDLING_H
 #define HANDLING_H
 
+#include <stdint.h>
+
+/* Main loop counters since handling_execute() started */
+typedef struct {
+    uint32_t ticks;            /* simulation ticks run */
+    uint32_t frames;           /* frames rendered */
+    uint32_t skipped_frames;   /* renders skipped because the display was still busy */
+    uint32_t missed_deadlines; /* ticks that ran late, as catch-up after another tick */
+    uint32_t dropped_ticks;    /* ticks discarded when the loop fell too far behind */
+} handling_loop_stats_t;
+
 void handling_execute(void);
 
-#endif /* handling.h */
\ No newline at end of file
+void handling_get_loop_stats(handling_loop_stats_t *stats);
+
+#endif /* handling.h */
@@ -0,0 +1,53 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "game/fixed.h"
+#include <stdint.h>
+
+/* Explosion debris: a fixed pool of point particles, one array per
+   component like the entity store, packed so that 0..count-1 are alive.
+   A full pool drops new particles instead of growing. particles_update()
+   is one pass that moves, ages and removes; particles_draw() hands all
+   of them to the renderer as a single batch.
+
+   Particles are cosmetic: they never collide, draw their randomness
+   from their own generator and stay out of game_state_hash(). */
+#ifndef PARTICLE_MAX
+#define PARTICLE_MAX 1024
+#endif
+
+/* Lifetime in ticks; the color steps through a ramp of 8 as it runs out */
+#define PARTICLE_LIFE_MAX 63
+
+typedef struct render_frame render_frame_t; /* game/render_queue.h */
+
+typedef enum {
+    PARTICLE_RAMP_FIRE,   /* white, yellow, orange, red: invaders */
+    PARTICLE_RAMP_DEBRIS, /* greens: shields */
+    PARTICLE_RAMPS
+} particle_ramp_t;
+
+typedef struct {
+    uint16_t active;
+    uint16_t capacity;
+    uint16_t high_water;
+    uint32_t spawned;
+    uint32_t dropped;    /* asked for while the pool was full */
+} particle_stats_t;
+
+/* Empty pool; the generator restarts, so a replay draws the same debris */
+void particles_init(void);
+
+/* count particles from (x, y) in random directions at up to speed px/s */
+void particles_burst(int x, int y, int count, fix16_t speed, particle_ramp_t ramp);
+
+/* Move by dt_us, pull down, age one tick, drop dead and off-screen ones */
+void particles_update(uint32_t dt_us);
+
+/* All live particles as the frame's point batch */
+void particles_draw(render_frame_t *frame);
+
+int particles_count(void);
+void particles_get_stats(particle_stats_t *stats);
+
+#endif /* PARTICLES_H */
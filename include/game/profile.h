@@ -0,0 +1,68 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+/* Per-phase frame timing. Build with GAME_PROFILE=1 to record how long
+   each phase takes into a histogram per phase; with the default of 0 the
+   PROFILE_* macros expand to nothing and no state is compiled in. */
+#ifndef GAME_PROFILE
+#define GAME_PROFILE 0
+#endif
+
+/* How often handling_execute() prints the summary (0 = only on demand) */
+#ifndef GAME_PROFILE_REPORT_MS
+#define GAME_PROFILE_REPORT_MS 5000
+#endif
+
+typedef enum {
+    PROFILE_INPUT,      /* joystick and buttons */
+    PROFILE_TICK,       /* one whole game_tick() */
+    PROFILE_ENEMIES,    /* enemies_update() */
+    PROFILE_PARTICLES,  /* particles_update() */
+    PROFILE_COLLISIONS, /* bullet and player hit tests */
+    PROFILE_SHIELDS,    /* shots against the shields, part of collisions */
+    PROFILE_DRAW,       /* begin_frame() and draw calls, including bus waits */
+    PROFILE_PRESENT,    /* st7735_present() */
+    PROFILE_LOOP,       /* busy time of one main loop iteration */
+    PROFILE_PHASE_COUNT
+} profile_phase_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} profile_summary_t;
+
+#if GAME_PROFILE
+
+#include "pico/time.h"
+
+/* Time the code between BEGIN and END of the same phase (same scope) */
+#define PROFILE_BEGIN(phase) uint32_t _profile_start_##phase = time_us_32()
+#define PROFILE_END(phase) profile_record(phase, time_us_32() - _profile_start_##phase)
+
+/* Safe from either core; each core records into its own histograms */
+void profile_record(profile_phase_t phase, uint32_t us);
+
+/* min/avg/p99/max since the last reset over both cores; p99 is the upper
+   bound of its histogram bucket (within 1/8 of the value) */
+void profile_get_summary(profile_phase_t phase, profile_summary_t *summary);
+
+/* Print one line per phase over stdio (UART), then start a new window */
+void profile_report(void);
+void profile_reset(void);
+
+#else
+
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+
+static inline void profile_report(void) {}
+static inline void profile_reset(void) {}
+
+#endif /* GAME_PROFILE */
+
+#endif /* PROFILE_H */
@@ -0,0 +1,118 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "game/entities.h"
+#include "game/formation.h"
+#include "game/particles.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Render frames and the queue that hands them from the simulation to the
+   renderer. A frame is a self-contained list of draw commands built from
+   the game state after a tick; once published it is never written again,
+   so the renderer (core 1 in the dual-core build) can draw it while core 0
+   simulates the next ticks. */
+/* Tiles are small 1bpp bitmaps whose pixels are copied into the frame,
+   for graphics the simulation changes (the shields) */
+#define RENDER_MAX_TILES  32
+#define RENDER_TILE_W     8
+#define RENDER_TILE_H     8
+
+#define RENDER_MAX_COMMANDS (ENTITY_MAX + FORMATION_MAX_ROWS * FORMATION_MAX_COLS + RENDER_MAX_TILES)
+
+/* Particles travel as one batch of points, drawn after the commands */
+#define RENDER_MAX_POINTS PARTICLE_MAX
+
+#ifndef RENDER_QUEUE_DEPTH
+#define RENDER_QUEUE_DEPTH 3
+#endif
+
+/* One sprite (or, without one, a filled rectangle) */
+typedef struct {
+    int16_t x, y;
+    uint8_t w, h;
+    uint8_t frame;
+    uint16_t color;
+    const st7735_sprite_t *sprite;
+    uint32_t tag;    /* content tag for tiles, 0 for const sprites */
+} render_command_t;
+
+typedef struct render_frame {
+    uint32_t tick;
+    uint16_t round;  /* bumped by game_reset(), redraws the static screens */
+    uint8_t screen;  /* gamestate_t */
+    uint16_t count;
+    uint16_t tile_count;
+    uint16_t point_count;
+    render_command_t commands[RENDER_MAX_COMMANDS];
+    st7735_sprite_t tiles[RENDER_MAX_TILES];
+    uint8_t tile_bits[RENDER_MAX_TILES][RENDER_TILE_H];
+    st7735_point_t points[RENDER_MAX_POINTS];
+} render_frame_t;
+
+static inline void render_frame_add(render_frame_t *frame, int x, int y, int w, int h, uint16_t color,
+                                    const st7735_sprite_t *sprite, int sprite_frame) {
+    if (frame->count == RENDER_MAX_COMMANDS) return;
+    render_command_t *c = &frame->commands[frame->count++];
+    c->x = (int16_t)x;
+    c->y = (int16_t)y;
+    c->w = (uint8_t)w;
+    c->h = (uint8_t)h;
+    c->frame = (uint8_t)sprite_frame;
+    c->color = color;
+    c->sprite = sprite;
+    c->tag = 0;
+}
+
+/* A tile of w x h pixels (at most RENDER_TILE_W x RENDER_TILE_H), one
+   byte per row with the leftmost pixel in bit 7. Copied into the frame;
+   unchanged tiles are tagged alike, so the display skips resending them. */
+static inline void render_frame_add_tile(render_frame_t *frame, int x, int y, int w, int h, uint16_t color,
+                                         const uint8_t *bits) {
+    if (frame->tile_count == RENDER_MAX_TILES || frame->count == RENDER_MAX_COMMANDS) return;
+    int t = frame->tile_count++;
+    uint32_t tag = 2166136261u;
+    for (int r = 0; r < h; r++) {
+        frame->tile_bits[t][r] = bits[r];
+        tag = (tag ^ bits[r]) * 16777619u;
+    }
+    frame->tiles[t] = (st7735_sprite_t){ (uint8_t)w, (uint8_t)h, 1, ST7735_SPRITE_1BPP, color, 0, frame->tile_bits[t] };
+    render_frame_add(frame, x, y, w, h, color, &frame->tiles[t], 0);
+    frame->commands[frame->count - 1].tag = tag | 1u; /* 0 would mean "untagged" */
+}
+
+/* =======================
+   Queue
+   =======================
+   Lock-free single producer, single consumer ring of frames. The producer
+   fills a slot in place and publishes it; the consumer draws from it in
+   place and releases it. Each index is written by one side only. */
+typedef struct {
+    uint32_t published;
+    uint32_t rendered;
+    uint32_t stalls;     /* producer found the ring full and dropped a frame */
+    uint16_t depth_max;  /* most frames waiting at once */
+} render_queue_stats_t;
+
+typedef struct {
+    render_frame_t slots[RENDER_QUEUE_DEPTH];
+    volatile uint32_t head; /* next slot to render; consumer writes */
+    volatile uint32_t tail; /* next slot to fill; producer writes */
+    render_queue_stats_t stats; /* producer side, except rendered */
+} render_queue_t;
+
+void render_queue_init(render_queue_t *q);
+
+/* Producer: the slot to fill, or NULL when the renderer is behind */
+render_frame_t *render_queue_begin(render_queue_t *q);
+void render_queue_publish(render_queue_t *q);
+
+/* Consumer: the oldest published frame, or NULL */
+const render_frame_t *render_queue_peek(render_queue_t *q);
+void render_queue_release(render_queue_t *q);
+
+/* Frames published but not yet released */
+int render_queue_depth(const render_queue_t *q);
+void render_queue_get_stats(const render_queue_t *q, render_queue_stats_t *stats);
+
+#endif /* RENDER_QUEUE_H */
@@ -0,0 +1,47 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "game/fixed.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Input recording and replay. A stream is the seed plus the (move, fire)
+   input of every tick, so feeding it back through game_seed(),
+   game_reset() and game_tick() reproduces the run exactly, on the board
+   or on the host.
+
+   Layout (little endian):
+     header  "SIR1", u16 tick rate, u16 reserved, u32 seed
+     runs    i8 move (-127..127), u8 fire << 7 | (ticks - 1)
+     end     i8 -128, u8 0, u32 ticks, u32 game_state_hash()
+   Unchanged input costs 2 bytes per 128 ticks. */
+#define REPLAY_HEADER_SIZE 12
+#define REPLAY_FOOTER_SIZE 10
+
+/* Stick input is quantized to 1/127 before the game sees it, live or
+   not, so a recorded value replays as exactly the same fix16_t */
+static inline int8_t replay_quantize(fix16_t move) {
+    int32_t q = (move * 127 + (move >= 0 ? FIX16_ONE / 2 : -FIX16_ONE / 2)) / FIX16_ONE;
+    return (int8_t)(q > 127 ? 127 : q < -127 ? -127 : q);
+}
+
+static inline fix16_t replay_move(int8_t q) {
+    return (fix16_t)q * FIX16_ONE / 127;
+}
+
+/* Recording into a caller-owned buffer */
+void replay_record_start(uint8_t *buf, size_t capacity, uint32_t seed);
+bool replay_record_tick(int8_t move, bool fire); /* false once the buffer is full */
+size_t replay_record_finish(uint32_t state_hash); /* stream length, 0 if it overflowed */
+bool replay_recording(void);
+
+/* Playback; the stream must stay valid until it ends */
+bool replay_play_start(const uint8_t *data, size_t length, uint32_t *seed);
+bool replay_play_tick(int8_t *move, bool *fire); /* false at the end */
+bool replay_playing(void);
+
+/* Footer of the stream being played: tick count and final state hash */
+bool replay_expected(uint32_t *ticks, uint32_t *state_hash);
+
+#endif /* REPLAY_H */
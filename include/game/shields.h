@@ -0,0 +1,40 @@
+#ifndef SHIELDS_H
+#define SHIELDS_H
+
+#include "game/render_queue.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Destructible bunkers between the invaders and the cannon. Each shield
+   is a 1bpp bitmap of one 32-bit word per row, leftmost pixel in bit 31,
+   so testing a shot against a row is a single AND and a crater is a
+   shifted mask cleared with AND-NOT. */
+#define SHIELD_COUNT 4
+#define SHIELD_W     22
+#define SHIELD_H     12
+#define SHIELD_Y     124
+
+/* Rendered as 8x6 tiles; only tiles whose pixels changed are resent */
+#define SHIELD_TILE_W     8
+#define SHIELD_TILE_H     6
+#define SHIELD_TILES_X    ((SHIELD_W + SHIELD_TILE_W - 1) / SHIELD_TILE_W)
+#define SHIELD_TILES_Y    ((SHIELD_H + SHIELD_TILE_H - 1) / SHIELD_TILE_H)
+
+/* Fresh shields */
+void shields_init(void);
+
+/* Box around all shields, for broadphase queries */
+void shields_get_bounds(int *x, int *y, int *w, int *h);
+
+/* A shot's box against the shields. On contact the first solid row in
+   the direction of travel (dir < 0: moving up) takes a crater and true
+   is returned; the shot is used up. */
+bool shields_hit(int x, int y, int w, int h, int dir);
+
+/* Tile commands for every non-empty tile */
+void shields_draw(render_frame_t *frame);
+
+/* Fold the bitmaps into a game_state_hash() */
+uint32_t shields_state_hash(uint32_t h);
+
+#endif /* SHIELDS_H */
@@ -0,0 +1,23 @@
+#ifndef SOUNDS_H
+#define SOUNDS_H
+
+#include "game/audio.h"
+
+/* Sound effects: 8-bit PCM at 8 kHz in flash, and the cues the game
+   calls when something happens. Cues only queue audio commands. */
+extern const audio_sample_t sound_shot;
+extern const audio_sample_t sound_explosion;
+extern const audio_sample_t sound_march;    /* one thump, pitched per note */
+
+void sounds_shot(void);
+void sounds_invader_killed(void);
+void sounds_player_hit(void);
+void sounds_wave_cleared(void);
+
+/* The four-note march, one note per formation step */
+void sounds_march_step(void);
+
+/* March starts again on its first note */
+void sounds_reset(void);
+
+#endif /* SOUNDS_H */
@@ -0,0 +1,19 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include "hal/displays/st7735.h"
+
+#define INVADER_WIDTH  10
+#define INVADER_HEIGHT 8
+#define INVADER_TYPES  3
+
+#define PLAYER_SPRITE_WIDTH  10
+#define PLAYER_SPRITE_HEIGHT 5
+
+/* Invader sprites (2 animation frames each), indexed by formation row */
+extern const st7735_sprite_t sprite_invaders[INVADER_TYPES];
+
+/* Player cannon */
+extern const st7735_sprite_t sprite_player;
+
+#endif /* SPRITES_H */
@@ -0,0 +1,46 @@
+#ifndef WAVES_H
+#define WAVES_H
+
+#include "game/fixed.h"
+#include "game/formation.h"
+#include <stdint.h>
+
+/* Wave definitions. Every wave is one const table entry (kept in flash):
+   formation shape, invader type per row, movement, and two curves that
+   set the step and fire intervals from the share of the wave still
+   alive, so a thinning formation speeds up like the arcade original.
+   After the last entry the last wave repeats. */
+#define WAVE_CURVE_POINTS 4
+
+/* alive is in percent of the wave's invaders, points from 100 down to 0;
+   intervals between points are interpolated linearly. ticks holds over
+   9 minutes at 120 Hz, so GAME_MS_TO_TICKS() values never wrap. */
+typedef struct {
+    uint8_t alive;
+    uint16_t ticks;
+} wave_point_t;
+
+typedef struct {
+    uint8_t rows, cols;
+    uint8_t x, y;                          /* start of the formation origin */
+    uint8_t col_pitch, row_pitch;
+    uint8_t step_px;                       /* sideways per step */
+    uint8_t drop_px;                       /* down at each edge */
+    uint16_t shape[FORMATION_MAX_ROWS];    /* alive mask per row at the start */
+    uint8_t types[FORMATION_MAX_ROWS];     /* sprite_invaders index per row */
+    wave_point_t move[WAVE_CURVE_POINTS];  /* ticks between steps */
+    wave_point_t fire[WAVE_CURVE_POINTS];  /* ticks between shots */
+    uint8_t max_shots;                     /* enemy shots in flight */
+    fix16_t shot_speed;                    /* px/s */
+} wave_def_t;
+
+extern const wave_def_t waves[];
+extern const int wave_count;
+
+/* Wave number n (0-based), repeating the last one past the table */
+const wave_def_t *wave_get(int n);
+
+/* Interval from a curve for alive of total invaders left */
+int wave_interval(const wave_point_t *curve, int alive, int total);
+
+#endif /* WAVES_H */
@@ -0,0 +1,43 @@
+#ifndef PWM_AUDIO_H
+#define PWM_AUDIO_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Mono audio on one GPIO as PWM (needs an RC low-pass or a small amplifier).
+// A DMA timer paces the samples into the PWM compare register. Two buffers
+// play alternately: each belongs to a DMA channel chained to the other, and
+// when one finishes the DMA interrupt refills it through the fill callback
+// while the other plays. The CPU only runs in that interrupt, once per
+// buffer; nothing else ever waits for audio.
+//
+// The interrupt (DMA_IRQ_1, shared) runs on the core that calls
+// pwm_audio_init().
+#define PWM_AUDIO_BUFFER_SAMPLES 256
+#define PWM_AUDIO_BITS 10 // PWM resolution; 150 MHz / 1024 = 146 kHz carrier
+
+// Fills count signed 16-bit samples; called from the interrupt
+typedef void (*pwm_audio_fill_t)(int16_t *samples, int count);
+
+typedef struct
+{
+    uint32_t buffers;   // buffers refilled
+    uint32_t fill_us_last;
+    uint32_t fill_us_max;
+    uint64_t fill_us_total;
+    uint32_t over_budget; // refills that took longer than a buffer plays
+    uint32_t budget_us;   // play time of one buffer
+} pwm_audio_stats_t;
+
+// Starts output at about sample_rate Hz (4 kHz and up); both buffers are
+// filled before the first sample plays. Returns false without a free DMA
+// timer or channels.
+bool pwm_audio_init(uint pin, uint32_t sample_rate, pwm_audio_fill_t fill);
+
+// The rate the DMA timer actually runs at
+uint32_t pwm_audio_sample_rate(void);
+
+void pwm_audio_get_stats(pwm_audio_stats_t *stats);
+
+#endif // PWM_AUDIO_H
@@ -3,6 +3,7 @@
 #define ST7735_H
 
 #include "hardware/spi.h"
+#include "hardware/pio.h"
 #include "pico/stdlib.h"
 #include <stdint.h>
 #include <stdbool.h>
@@ -17,8 +18,103 @@ void st7735_draw_pixel(int x, int y, uint16_t color);
 void st7735_fill_rect(int x, int y, int w, int h, uint16_t color);
 void st7735_fill_screen(uint16_t color);
 void st7735_draw_string(int x, int y, const char *str, uint16_t color, uint16_t bg_color);
+
+// Sprites: frames are stored back to back in flash (const data). 1bpp rows
+// are packed MSB first, (width + 7) / 8 bytes per row, set bits are drawn in
+// `color` and clear bits are transparent. RGB565 sprites skip pixels equal to
+// `transparent`. Without a framebuffer transparent pixels are drawn black.
+typedef enum
+{
+    ST7735_SPRITE_1BPP,
+    ST7735_SPRITE_RGB565
+} st7735_sprite_format_t;
+
+typedef struct
+{
+    uint8_t width;
+    uint8_t height;
+    uint8_t frames;
+    uint8_t format;       // st7735_sprite_format_t
+    uint16_t color;       // 1bpp: color of set bits
+    uint16_t transparent; // RGB565: color key
+    const void *data;
+} st7735_sprite_t;
+
+void st7735_draw_sprite(int x, int y, const st7735_sprite_t *sprite, int frame);
+
+// Same, for sprites whose pixels change (e.g. a bitmap built every frame):
+// tag identifies the content instead of the sprite's address, so with dirty
+// tracking an unchanged copy at the same place is not sent again. 0 = use
+// the address.
+void st7735_draw_sprite_tagged(int x, int y, const st7735_sprite_t *sprite, int frame, uint32_t tag);
+
+// Batched points: plots count single pixels, each in its own RGB565 color,
+// in one call (particles). Points off the screen are skipped. With dirty
+// tracking the area is recorded per 16x16 cell rather than per point; in
+// strip mode the array is read at present() time.
+typedef struct
+{
+    uint8_t x, y;
+    uint16_t color;
+} st7735_point_t;
+
+void st7735_draw_points(const st7735_point_t *points, int count);
 uint16_t st7735_rgb(uint8_t r, uint8_t g, uint8_t b);
 void st7735_set_addr_window(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
 void st7735_write_data_buffer(const uint8_t *buffer, size_t len);
 
+// Batched transaction: CASET, RASET and RAMWR go out under one CS assertion,
+// then pixel bytes follow until st7735_end_write().
+void st7735_begin_write(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+void st7735_write_pixels(const uint8_t *buffer, size_t len);
+void st7735_end_write(void);
+
+// Solid fills and frame flushes run on DMA in the background. Every display
+// call waits for the previous transfer; st7735_is_busy() polls it without
+// blocking and st7735_wait() blocks until the bus is idle.
+bool st7735_is_busy(void);
+void st7735_wait(void);
+
+// Framebuffer mode: drawing calls render into a 128x160 RAM buffer and
+// st7735_present() streams the whole frame to the panel with one DMA transfer.
+void st7735_set_framebuffer(bool enable);
+bool st7735_framebuffer_enabled(void);
+void st7735_present(void);
+
+// Strip mode (low memory): drawing calls are recorded in a per-frame display
+// list and st7735_present() rasterizes it 16 lines at a time into two small
+// buffers, one being sent while the next is drawn. fill_screen() and
+// begin_frame() start a new list; pixel buffers passed to draw calls are read
+// at present() time. Switches framebuffer and pipelined mode off.
+void st7735_set_strip_mode(bool enable);
+
+// Dirty-rectangle tracking for framebuffer mode: st7735_begin_frame() erases
+// only what the previous frame drew, st7735_present() sends only the changed
+// regions. st7735_get_bytes_sent() counts every byte written over SPI.
+void st7735_set_dirty_tracking(bool enable);
+void st7735_begin_frame(uint16_t bg_color);
+uint32_t st7735_get_bytes_sent(void);
+
+// Pipelined mode: two framebuffers, core 1 sends frame N while core 0 draws
+// frame N+1. present() only waits (stalls) if core 1 is still busy.
+typedef struct
+{
+    uint32_t frames_presented; // frames handed to core 1
+    uint32_t frames_stalled;   // times core 0 had to wait for core 1
+    uint64_t stall_us;         // total time spent waiting
+} st7735_pipeline_stats_t;
+
+void st7735_set_pipelined(bool enable);
+void st7735_get_pipeline_stats(st7735_pipeline_stats_t *stats);
+
+// Moves the display interface from the SPI block to a PIO state machine
+// (pio/st7735.pio) that drives CS, SCK, MOSI and D/C itself. Framebuffer
+// flushes then go out as one DMA-chained display list. SCK must be the pin
+// after CS. Call after st7735_begin().
+bool st7735_use_pio(PIO pio, uint sck_pin, uint mosi_pin);
+
+// Stops the state machine, frees it, its program and the display-list DMA
+// channels, and puts the pins back on the SPI block. st7735_init() calls it.
+void st7735_release_pio(void);
+
 #endif // ST7735_H
\ No newline at end of file
@@ -52,7 +52,10 @@ void abgabe_09_execute(void)
             set_state(GAMESTATE_PLAYING);
         }
 
-        game_update(move, fire);
+        // One fixed 50 ms step per iteration
+        for (int t = 0; t < 50000 / GAME_TICK_US; t++)
+            game_tick(fix16_from_int(move), fire);
+        game_render();
         sleep_ms(50);
     }
 }
@@ -3,6 +3,10 @@
 #include "pico/stdlib.h"
 #include <stdio.h>
 
+// Panel wiring
+#define DISPLAY_SCK_PIN  18
+#define DISPLAY_MOSI_PIN 19
+
 void init_display(void)
 {
     // backlight pin
@@ -15,13 +19,19 @@ void init_display(void)
 
     // Set SPI pin functions
     gpio_set_function(16, GPIO_FUNC_SPI);
-    gpio_set_function(18, GPIO_FUNC_SPI);
-    gpio_set_function(19, GPIO_FUNC_SPI);
+    gpio_set_function(DISPLAY_SCK_PIN, GPIO_FUNC_SPI);
+    gpio_set_function(DISPLAY_MOSI_PIN, GPIO_FUNC_SPI);
 
     // Initialize ST7735 display
     st7735_init(spi0, 6, 17, 3, 0, false);
 }
 
+bool display_use_pio(void)
+{
+    // SCK and MOSI move from the SPI block to the PIO state machine
+    return st7735_use_pio(pio1, DISPLAY_SCK_PIN, DISPLAY_MOSI_PIN);
+}
+
 void display_demo_execute(void)
 {
 
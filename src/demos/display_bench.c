@@ -0,0 +1,168 @@
+#include "demos/display_bench.h"
+#include "demos/display.h"
+#include "game/sprites.h"
+#include "hal/displays/st7735.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+// Same wiring as init_display()
+#define BENCH_CS_PIN 17
+#define BENCH_DC_PIN 3
+
+#define BENCH_ITERATIONS 1000
+
+// Address window setup as it was done before the batched transaction:
+// every byte in its own CS/DC toggled transfer (11 transactions).
+static void legacy_write(bool dc, uint8_t byte)
+{
+    gpio_put(BENCH_DC_PIN, dc);
+    gpio_put(BENCH_CS_PIN, 0);
+    spi_write_blocking(spi0, &byte, 1);
+    gpio_put(BENCH_CS_PIN, 1);
+}
+
+static void legacy_set_addr_window(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    legacy_write(0, 0x2A);
+    legacy_write(1, 0x00);
+    legacy_write(1, x0);
+    legacy_write(1, 0x00);
+    legacy_write(1, x1);
+    legacy_write(0, 0x2B);
+    legacy_write(1, 0x00);
+    legacy_write(1, y0);
+    legacy_write(1, 0x00);
+    legacy_write(1, y1);
+    legacy_write(0, 0x2C);
+}
+
+// A 2x6 bullet drawn the old way: 11 setup transactions plus the pixels
+static void legacy_bullet(int x, int y, const uint8_t *pixels)
+{
+    legacy_set_addr_window(x, y, x + 1, y + 5);
+    st7735_write_data_buffer(pixels, 2 * 6 * 2);
+}
+
+// The same bullet in one batched transaction
+static void batched_bullet(int x, int y, const uint8_t *pixels)
+{
+    st7735_begin_write(x, y, x + 1, y + 5);
+    st7735_write_pixels(pixels, 2 * 6 * 2);
+    st7735_end_write();
+}
+
+// extra_bytes: bytes per call sent around the driver (and not counted by it)
+static void bench_report(const char *name, uint64_t start_us, uint32_t bytes_start, uint32_t extra_bytes)
+{
+    uint64_t elapsed_us = time_us_64() - start_us;
+    uint32_t bytes = st7735_get_bytes_sent() - bytes_start + extra_bytes * BENCH_ITERATIONS;
+    printf("%-26s %6lu ns/call %5lu bytes/call\n", name,
+           (unsigned long)(elapsed_us * 1000 / BENCH_ITERATIONS),
+           (unsigned long)(bytes / BENCH_ITERATIONS));
+}
+
+void display_bench_execute(void)
+{
+    init_display();
+    st7735_begin();
+    st7735_fill_screen(st7735_rgb(0, 0, 0));
+    st7735_wait();
+
+    uint8_t pixels[2 * 6 * 2];
+    for (size_t i = 0; i < sizeof(pixels); i += 2)
+    {
+        pixels[i] = 0xF8; // red, high byte first
+        pixels[i + 1] = 0x00;
+    }
+
+    printf("Display benchmark, %d iterations, SPI %lu Hz\n", BENCH_ITERATIONS,
+           (unsigned long)spi_get_baudrate(spi0));
+
+    uint64_t start = time_us_64();
+    uint32_t bytes = st7735_get_bytes_sent();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        legacy_bullet(i % 120, i % 150, pixels);
+    }
+    bench_report("2x6 rect, 11 transactions", start, bytes, 11);
+
+    start = time_us_64();
+    bytes = st7735_get_bytes_sent();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        batched_bullet(i % 120, i % 150, pixels);
+    }
+    bench_report("2x6 rect, batched", start, bytes, 0);
+
+    start = time_us_64();
+    bytes = st7735_get_bytes_sent();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        st7735_fill_rect(i % 120, i % 150, 2, 6, st7735_rgb(255, 0, 0));
+    }
+    st7735_wait();
+    bench_report("st7735_fill_rect 2x6", start, bytes, 0);
+
+    start = time_us_64();
+    bytes = st7735_get_bytes_sent();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        st7735_draw_pixel(i % 128, i % 160, st7735_rgb(255, 255, 255));
+    }
+    bench_report("st7735_draw_pixel", start, bytes, 0);
+
+    // Text: a full 21-character line (126 px), one address window per string
+    static const char line[] = "SPACE INVADERS 012345";
+    const int chars = sizeof(line) - 1;
+    start = time_us_64();
+    bytes = st7735_get_bytes_sent();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        st7735_draw_string(0, i % 152, line, st7735_rgb(255, 255, 255), 0);
+    }
+    uint64_t text_us = time_us_64() - start;
+    bench_report("st7735_draw_string 21 ch", start, bytes, 0);
+    printf("%-26s %6lu chars/s\n", "", (unsigned long)((uint64_t)chars * BENCH_ITERATIONS * 1000000 / text_us));
+
+    // Framebuffer mode: rendering only, the frame is sent once at the end
+    st7735_set_framebuffer(true);
+    start = time_us_64();
+    bytes = st7735_get_bytes_sent();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        st7735_draw_string(0, i % 152, line, st7735_rgb(255, 255, 255), 0);
+    }
+    bench_report("draw_string 21 ch (fb)", start, bytes, 0);
+
+    // Sprites: cost per blit into the framebuffer
+    start = time_us_64();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        st7735_draw_sprite(i % 118, i % 152, &sprite_invaders[i % INVADER_TYPES], i);
+    }
+    bench_report("sprite 10x8 1bpp (fb)", start, bytes, 0);
+
+    start = time_us_64();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        st7735_draw_sprite(i % 118, i % 155, &sprite_player, 0);
+    }
+    bench_report("sprite 10x5 rgb565 (fb)", start, bytes, 0);
+    st7735_present();
+    st7735_wait();
+    st7735_set_framebuffer(false);
+
+    // Sprites without a framebuffer: blit plus one window and transfer each
+    start = time_us_64();
+    bytes = st7735_get_bytes_sent();
+    for (int i = 0; i < BENCH_ITERATIONS; i++)
+    {
+        st7735_draw_sprite(i % 118, i % 152, &sprite_invaders[i % INVADER_TYPES], i);
+    }
+    bench_report("sprite 10x8 1bpp", start, bytes, 0);
+
+    while (true)
+    {
+        tight_loop_contents();
+    }
+}
@@ -0,0 +1,125 @@
+#include "demos/fixed_bench.h"
+#include "game/fixed.h"
+#include "pico/stdlib.h"
+#include <math.h>
+#include <stdio.h>
+
+// Motion update as the game does it, once in Q16.16 and once in float
+// (the Cortex-M33 has a single-precision FPU): integrate position with a
+// varying timestep, bounce off the playfield edges and convert to whole
+// pixels for drawing.
+#define BENCH_ENTITIES 64
+#define BENCH_TICKS 1000
+#define FIELD_W 128
+#define FIELD_H 160
+
+typedef struct
+{
+    fix16_t x, y, vx, vy;
+} fixed_body_t;
+
+typedef struct
+{
+    float x, y, vx, vy;
+} float_body_t;
+
+static fixed_body_t _fixed[BENCH_ENTITIES];
+static float_body_t _float[BENCH_ENTITIES];
+
+// Ticks of slightly different length, like a loop that catches up
+static const uint32_t _dt_us[4] = {8333, 8334, 8333, 9000};
+
+static void bench_init(void)
+{
+    for (int i = 0; i < BENCH_ENTITIES; i++)
+    {
+        int x = (i * 37) % FIELD_W;
+        int y = (i * 53) % FIELD_H;
+        int vx = 20 + (i * 7) % 90;
+        int vy = -(30 + (i * 11) % 70);
+        _fixed[i] = (fixed_body_t){fix16_from_int(x), fix16_from_int(y), fix16_from_int(vx), fix16_from_int(vy)};
+        _float[i] = (float_body_t){(float)x, (float)y, (float)vx, (float)vy};
+    }
+}
+
+static uint32_t fixed_tick(uint32_t dt_us)
+{
+    uint32_t checksum = 0;
+    for (int i = 0; i < BENCH_ENTITIES; i++)
+    {
+        fixed_body_t *b = &_fixed[i];
+        b->x += fix16_distance(b->vx, dt_us);
+        b->y += fix16_distance(b->vy, dt_us);
+        if (b->x < 0 || b->x > fix16_from_int(FIELD_W - 1))
+        {
+            b->vx = -b->vx;
+            b->x = fix16_clamp(b->x, 0, fix16_from_int(FIELD_W - 1));
+        }
+        if (b->y < 0 || b->y > fix16_from_int(FIELD_H - 1))
+        {
+            b->vy = -b->vy;
+            b->y = fix16_clamp(b->y, 0, fix16_from_int(FIELD_H - 1));
+        }
+        checksum += (uint32_t)(fix16_to_int(b->x) + fix16_to_int(b->y));
+    }
+    return checksum;
+}
+
+static uint32_t float_tick(uint32_t dt_us)
+{
+    uint32_t checksum = 0;
+    float dt = (float)dt_us * 1e-6f;
+    for (int i = 0; i < BENCH_ENTITIES; i++)
+    {
+        float_body_t *b = &_float[i];
+        b->x += b->vx * dt;
+        b->y += b->vy * dt;
+        if (b->x < 0.0f || b->x > (float)(FIELD_W - 1))
+        {
+            b->vx = -b->vx;
+            b->x = fminf(fmaxf(b->x, 0.0f), (float)(FIELD_W - 1));
+        }
+        if (b->y < 0.0f || b->y > (float)(FIELD_H - 1))
+        {
+            b->vy = -b->vy;
+            b->y = fminf(fmaxf(b->y, 0.0f), (float)(FIELD_H - 1));
+        }
+        checksum += (uint32_t)((int)floorf(b->x) + (int)floorf(b->y));
+    }
+    return checksum;
+}
+
+static void bench_report(const char *name, uint64_t elapsed_us, uint32_t checksum)
+{
+    printf("%-8s %6lu ns/entity %8lu us total  (checksum %08lx)\n", name,
+           (unsigned long)(elapsed_us * 1000 / ((uint64_t)BENCH_TICKS * BENCH_ENTITIES)),
+           (unsigned long)elapsed_us, (unsigned long)checksum);
+}
+
+void fixed_bench_execute(void)
+{
+    printf("Motion benchmark, %d entities x %d ticks\n", BENCH_ENTITIES, BENCH_TICKS);
+
+    while (true)
+    {
+        bench_init();
+        uint32_t checksum = 0;
+        uint64_t start = time_us_64();
+        for (int t = 0; t < BENCH_TICKS; t++)
+        {
+            checksum += fixed_tick(_dt_us[t & 3]);
+        }
+        bench_report("Q16.16", time_us_64() - start, checksum);
+
+        checksum = 0;
+        start = time_us_64();
+        for (int t = 0; t < BENCH_TICKS; t++)
+        {
+            checksum += float_tick(_dt_us[t & 3]);
+        }
+        bench_report("float", time_us_64() - start, checksum);
+
+        // The two checksums differ slightly: the models round differently
+        sleep_ms(2000);
+    }
+}
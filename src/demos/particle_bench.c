@@ -0,0 +1,106 @@
+#include "demos/particle_bench.h"
+#include "demos/display.h"
+#include "game/game.h"
+#include "game/particles.h"
+#include "game/render_queue.h"
+#include "hal/displays/st7735.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Particle stress test on the board: the pool is held at a given count by
+// explosion bursts, and each 60 fps frame runs the two 120 Hz ticks of
+// particles_update(), builds the point batch, draws it and presents with
+// the game's default renderer (framebuffer, dirty tracking). All of it runs
+// on one core, so the numbers include what core 1 does in the game.
+#define BENCH_FRAMES 240
+#define BENCH_STEP 64
+#define FRAME_BUDGET_US (1000000 / 60)
+#define TICKS_PER_FRAME (GAME_TICK_HZ / 60)
+
+static render_frame_t _frame;
+
+// Bursts at random places until the pool holds n particles
+static void top_up(int n)
+{
+    while (particles_count() < n)
+    {
+        int missing = n - particles_count();
+        particles_burst(8 + rand() % 112, 16 + rand() % 112, missing < 24 ? missing : 24, FIX16(70),
+                        PARTICLE_RAMP_FIRE);
+    }
+}
+
+// Returns the slowest frame in us
+static uint32_t bench_count(int n)
+{
+    uint64_t update_us = 0, draw_us = 0, present_us = 0;
+    uint32_t worst_us = 0;
+    uint32_t bytes = st7735_get_bytes_sent();
+
+    particles_init();
+    srand(n);
+    for (int f = 0; f < BENCH_FRAMES; f++)
+    {
+        top_up(n);
+        uint64_t start = time_us_64();
+        for (int t = 0; t < TICKS_PER_FRAME; t++)
+        {
+            particles_update(GAME_TICK_US);
+        }
+        uint64_t updated = time_us_64();
+        _frame.point_count = 0;
+        particles_draw(&_frame);
+        st7735_begin_frame(st7735_rgb(0, 0, 0));
+        st7735_draw_points(_frame.points, _frame.point_count);
+        uint64_t drawn = time_us_64();
+        st7735_present();
+        st7735_wait();
+        uint64_t end = time_us_64();
+
+        update_us += updated - start;
+        draw_us += drawn - updated;
+        present_us += end - drawn;
+        if (end - start > worst_us)
+        {
+            worst_us = (uint32_t)(end - start);
+        }
+    }
+
+    printf("%5d %8lu %8lu %8lu %8lu %8lu %9lu\n", n, (unsigned long)(update_us / BENCH_FRAMES),
+           (unsigned long)(draw_us / BENCH_FRAMES), (unsigned long)(present_us / BENCH_FRAMES),
+           (unsigned long)((update_us + draw_us + present_us) / BENCH_FRAMES), (unsigned long)worst_us,
+           (unsigned long)((st7735_get_bytes_sent() - bytes) / BENCH_FRAMES));
+    return worst_us;
+}
+
+void particle_bench_execute(void)
+{
+    init_display();
+    st7735_begin();
+    st7735_set_framebuffer(true);
+    st7735_set_dirty_tracking(true);
+    st7735_fill_screen(st7735_rgb(0, 0, 0));
+    st7735_present();
+    st7735_wait();
+
+    while (true)
+    {
+        printf("Particle benchmark, %d frames per count, us per frame, budget %d us\n", BENCH_FRAMES,
+               FRAME_BUDGET_US);
+        printf("%5s %8s %8s %8s %8s %8s %9s\n", "count", "update", "draw", "present", "mean", "worst",
+               "bytes");
+        int sustained = 0;
+        for (int n = BENCH_STEP; n <= PARTICLE_MAX; n += BENCH_STEP)
+        {
+            if (bench_count(n) > FRAME_BUDGET_US)
+            {
+                break;
+            }
+            sustained = n;
+        }
+        printf("Sustained at 60 fps: %d particles%s\n", sustained,
+               sustained == PARTICLE_MAX ? " (the whole pool, PARTICLE_MAX)" : "");
+        sleep_ms(5000);
+    }
+}
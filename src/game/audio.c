@@ -0,0 +1,131 @@
+#include "game/audio.h"
+#include "hardware/sync.h"
+
+#define MASTER_DEFAULT 128 /* two full-scale channels before clipping */
+
+/* Position and step are Q16.16 sample indices, so a channel plays its
+   sample at any rate with one add per output sample */
+typedef struct {
+    const int8_t *data; /* NULL: silent */
+    uint32_t pos;
+    uint32_t end;
+    uint32_t step;
+    int32_t volume;
+} voice_t;
+
+typedef struct {
+    const audio_sample_t *sample;
+    uint32_t step;
+    uint8_t channel;
+    uint8_t volume;
+} audio_cmd_t;
+
+static voice_t voices[AUDIO_CHANNELS];
+static int32_t mix_buf[AUDIO_MAX_BUFFER];
+static int32_t master = MASTER_DEFAULT;
+static audio_stats_t stats;
+
+/* =======================
+   Command queue
+   =======================
+   Indices count up forever, as in the render queue; the producer only
+   writes tail, the mixer only head. */
+static audio_cmd_t queue[AUDIO_QUEUE_DEPTH];
+static volatile uint32_t queue_head;
+static volatile uint32_t queue_tail;
+
+void audio_init(void) {
+    for (int c = 0; c < AUDIO_CHANNELS; c++)
+        voices[c].data = NULL;
+    queue_head = 0;
+    queue_tail = 0;
+    master = MASTER_DEFAULT;
+    stats = (audio_stats_t){0};
+}
+
+bool audio_play(audio_channel_t channel, const audio_sample_t *sample, uint32_t pitch, uint8_t volume) {
+    if (queue_tail - queue_head == AUDIO_QUEUE_DEPTH) {
+        stats.dropped++;
+        return false;
+    }
+    audio_cmd_t *cmd = &queue[queue_tail % AUDIO_QUEUE_DEPTH];
+    cmd->sample = sample;
+    cmd->channel = (uint8_t)channel;
+    cmd->volume = volume;
+    /* Sample rate ratio times pitch; the division stays out of the mixer */
+    cmd->step = sample ? (uint32_t)(((uint64_t)sample->rate * pitch) / AUDIO_SAMPLE_RATE) : 0;
+    if (sample && cmd->step == 0) cmd->step = 1;
+    __dmb(); /* command before the new tail */
+    queue_tail++;
+    return true;
+}
+
+static void take_commands(void) {
+    while (queue_head != queue_tail) {
+        __dmb(); /* tail before the command */
+        const audio_cmd_t *cmd = &queue[queue_head % AUDIO_QUEUE_DEPTH];
+        voice_t *v = &voices[cmd->channel];
+        if (cmd->sample) {
+            v->data = cmd->sample->data;
+            v->pos = 0;
+            v->end = (uint32_t)cmd->sample->length << 16;
+            v->step = cmd->step;
+            v->volume = cmd->volume;
+        } else {
+            v->data = NULL;
+        }
+        __dmb(); /* done reading before the slot is handed back */
+        queue_head++;
+        stats.played++;
+    }
+}
+
+void audio_mix(int16_t *out, int count) {
+    if (count > AUDIO_MAX_BUFFER) count = AUDIO_MAX_BUFFER;
+    take_commands();
+
+    /* One pass per playing channel into a 32-bit sum */
+    for (int i = 0; i < count; i++)
+        mix_buf[i] = 0;
+    for (int c = 0; c < AUDIO_CHANNELS; c++) {
+        voice_t *v = &voices[c];
+        if (!v->data) continue;
+        const int8_t *data = v->data;
+        uint32_t pos = v->pos, end = v->end, step = v->step;
+        int32_t volume = v->volume;
+        int n = count;
+        /* Stop at the end of the sample instead of testing every step */
+        uint32_t left = (end - pos + step - 1) / step;
+        if (left < (uint32_t)n) n = (int)left;
+        for (int i = 0; i < n; i++) {
+            mix_buf[i] += data[pos >> 16] * volume;
+            pos += step;
+        }
+        v->pos = pos;
+        if (pos >= end) v->data = NULL;
+    }
+
+    /* Master volume, then clamp to 16 bits */
+    uint32_t clipped = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t s = (mix_buf[i] * master) >> 8;
+        if (s > INT16_MAX) {
+            s = INT16_MAX;
+            clipped++;
+        } else if (s < INT16_MIN) {
+            s = INT16_MIN;
+            clipped++;
+        }
+        out[i] = (int16_t)s;
+    }
+    stats.clipped += clipped;
+    stats.buffers++;
+}
+
+void audio_set_master(uint16_t volume) {
+    master = volume > 256 ? 256 : volume;
+}
+
+void audio_get_stats(audio_stats_t *out) {
+    *out = stats;
+}
@@ -0,0 +1,98 @@
+#include "game/broadphase.h"
+
+/* Cell range covered by [lo, lo + len), clamped to the grid */
+static void cell_span(int lo, int len, int cells, int *first, int *last) {
+    int a = lo >> BROADPHASE_CELL_SHIFT;
+    int b = (lo + len - 1) >> BROADPHASE_CELL_SHIFT;
+    if (a < 0) a = 0;
+    if (b > cells - 1) b = cells - 1;
+    *first = a;
+    *last = b;
+}
+
+void broadphase_clear(broadphase_t *grid) {
+    for (int i = 0; i < BROADPHASE_CELLS; i++)
+        grid->head[i] = -1;
+    grid->entry_count = 0;
+    grid->link_count = 0;
+}
+
+bool broadphase_insert(broadphase_t *grid, int x, int y, int w, int h,
+                       uint8_t layer, uint16_t id) {
+    if (grid->entry_count == BROADPHASE_MAX_ENTRIES || w <= 0 || h <= 0)
+        return false;
+
+    int cx0, cx1, cy0, cy1;
+    cell_span(x, w, BROADPHASE_COLS, &cx0, &cx1);
+    cell_span(y, h, BROADPHASE_ROWS, &cy0, &cy1);
+    if (cx0 > cx1 || cy0 > cy1)
+        return false; /* entirely off the playfield */
+    if (grid->link_count + (cx1 - cx0 + 1) * (cy1 - cy0 + 1) > BROADPHASE_MAX_LINKS)
+        return false;
+
+    int index = grid->entry_count++;
+    broadphase_entry_t *e = &grid->entries[index];
+    e->x = (int16_t)x;
+    e->y = (int16_t)y;
+    e->w = (uint8_t)w;
+    e->h = (uint8_t)h;
+    e->layer = layer;
+    e->id = id;
+    e->stamp = grid->stamp;
+
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            int cell = cy * BROADPHASE_COLS + cx;
+            broadphase_link_t *link = &grid->links[grid->link_count];
+            link->entry = (int16_t)index;
+            link->next = grid->head[cell];
+            grid->head[cell] = (int16_t)grid->link_count++;
+        }
+    }
+    return true;
+}
+
+int broadphase_query(broadphase_t *grid, int x, int y, int w, int h,
+                     uint8_t layer_mask, uint16_t *ids, int max_ids) {
+    int cx0, cx1, cy0, cy1;
+    cell_span(x, w, BROADPHASE_COLS, &cx0, &cx1);
+    cell_span(y, h, BROADPHASE_ROWS, &cy0, &cy1);
+
+    /* A new stamp marks entries already reported by this query (they can
+       sit in several cells); on wrap-around old marks are cleared */
+    if (++grid->stamp == 0) {
+        for (int i = 0; i < grid->entry_count; i++)
+            grid->entries[i].stamp = 0;
+        grid->stamp = 1;
+    }
+
+    int found = 0;
+    int indices[BROADPHASE_MAX_ENTRIES];
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            for (int l = grid->head[cy * BROADPHASE_COLS + cx]; l >= 0; l = grid->links[l].next) {
+                int index = grid->links[l].entry;
+                broadphase_entry_t *e = &grid->entries[index];
+                if (e->stamp == grid->stamp || !(e->layer & layer_mask))
+                    continue;
+                e->stamp = grid->stamp;
+                if (e->x < x + w && x < e->x + e->w && e->y < y + h && y < e->y + e->h)
+                    indices[found++] = index;
+            }
+        }
+    }
+
+    /* Report in insertion order so results do not depend on the cells */
+    for (int i = 1; i < found; i++) {
+        int v = indices[i], j = i;
+        while (j > 0 && indices[j - 1] > v) {
+            indices[j] = indices[j - 1];
+            j--;
+        }
+        indices[j] = v;
+    }
+    if (found > max_ids) found = max_ids;
+    for (int i = 0; i < found; i++)
+        ids[i] = grid->entries[indices[i]].id;
+    return found;
+}
@@ -1,137 +1,156 @@
 #include "game/enemies.h"
+#include "game/formation.h"
+#include "game/game.h"
+#include "game/entities.h"
+#include "game/particles.h"
+#include "game/sounds.h"
+#include "game/sprites.h"
+#include "game/waves.h"
 #include "hal/displays/st7735.h"
-#include "pico/time.h"
 #include <stdlib.h>
 #include <stdbool.h>
 
 #define SCREEN_WIDTH 128
-#define ENEMY_ROWS 3
-#define ENEMY_COLS 6
-#define MAX_ENEMIES (ENEMY_ROWS * ENEMY_COLS)
-#define MAX_ENEMY_BULLETS 5
-
-typedef struct {
-    int x, y;
-    bool alive;
-} Enemy;
-
-typedef struct {
-    int x, y;
-    bool active;
-} EnemyBullet;
-
-static Enemy enemies[MAX_ENEMIES];
-static EnemyBullet enemy_bullets[MAX_ENEMY_BULLETS];
+#define WAVE_PAUSE_TICKS GAME_MS_TO_TICKS(1500) /* empty screen between waves */
+#define INVADER_DEBRIS 24 /* particles per destroyed invader */
+
+static const entity_def_t enemy_shot_def = {
+    ENTITY_ENEMY_SHOT, 2, 6, BROADPHASE_ENEMY_BULLET, ENTITY_CULL, 0xFFE0 /* yellow */, NULL
+};
+
+static formation_t formation;
+static const wave_def_t *wave;
+static int wave_number;       /* 0-based, keeps counting past the table */
+static int wave_size;         /* invaders the wave started with */
+static int next_wave;         /* wave to start once the pause is over, -1 = none */
+static uint32_t pause_start;
+static uint32_t pause_ticks;
 static int enemy_dir = 1;
-static absolute_time_t last_enemy_move;
-static absolute_time_t last_enemy_shot;
-static uint32_t enemy_move_interval = 300000;
-static uint32_t enemy_shot_interval_us = 800000;
+static int enemy_frame = 0; /* animation frame, flips with every step */
+static uint32_t last_enemy_move;
+static uint32_t last_enemy_shot;
+
+static void start_wave(int n, uint32_t tick) {
+    wave = wave_get(n);
+    wave_number = n;
+    next_wave = -1;
+    pause_start = tick; /* hashed: nothing may carry over from an earlier run */
+    pause_ticks = 0;
+    formation_init(&formation, wave->rows, wave->cols, wave->x, wave->y,
+                   wave->col_pitch, wave->row_pitch, INVADER_WIDTH, INVADER_HEIGHT);
+    formation_set_shape(&formation, wave->shape);
+    wave_size = formation.alive_count;
+
+    enemy_dir = 1;
+    enemy_frame = 0;
+    last_enemy_move = tick;
+    last_enemy_shot = tick;
+}
 
 void enemies_init(void) {
-    int index = 0;
-    for (int row = 0; row < ENEMY_ROWS; row++) {
-        for (int col = 0; col < ENEMY_COLS; col++) {
-            enemies[index].x = 10 + col * 18;
-            enemies[index].y = 20 + row * 15;
-            enemies[index].alive = true;
-            index++;
-        }
-    }
+    start_wave(0, 0);
+}
 
-    for (int i = 0; i < MAX_ENEMY_BULLETS; i++)
-        enemy_bullets[i].active = false;
+void enemies_start_wave(int n) {
+    next_wave = n;
+    pause_ticks = 0;
+}
 
-    enemy_dir = 1;
-    last_enemy_move = get_absolute_time();
-    last_enemy_shot = get_absolute_time();
+int enemies_wave(void) {
+    return wave_number;
 }
 
-void enemies_update(void) {
-    absolute_time_t now = get_absolute_time();
-
-    // Enemy Movement
-    if (absolute_time_diff_us(last_enemy_move, now) >= enemy_move_interval) {
-        bool edge_hit = false;
-        for (int i = 0; i < MAX_ENEMIES; i++) {
-            if (!enemies[i].alive) continue;
-            enemies[i].x += enemy_dir * 2;
-            if (enemies[i].x <= 0 || enemies[i].x >= SCREEN_WIDTH - 10)
-                edge_hit = true;
-        }
-        if (edge_hit) {
+void enemies_update(uint32_t tick) {
+    // Next wave once this one is cleared and the pause is over
+    if (next_wave >= 0) {
+        if (tick - pause_start < pause_ticks) return;
+        start_wave(next_wave, tick);
+    }
+    if (formation.alive_count == 0) {
+        next_wave = wave_number + 1;
+        pause_start = tick;
+        pause_ticks = WAVE_PAUSE_TICKS;
+        sounds_wave_cleared();
+        return;
+    }
+
+    // Enemy Movement: the fewer invaders are left, the shorter the interval
+    if (tick - last_enemy_move >= (uint32_t)wave_interval(wave->move, formation.alive_count, wave_size)) {
+        /* The whole formation moves with its origin; only the outermost
+           alive columns can touch the screen edges */
+        formation.x += enemy_dir * wave->step_px;
+        if (formation_left(&formation) <= 0 ||
+            formation_right(&formation) >= SCREEN_WIDTH - INVADER_WIDTH) {
             enemy_dir *= -1;
-            for (int i = 0; i < MAX_ENEMIES; i++)
-                enemies[i].y += 5;
+            formation.y += wave->drop_px;
         }
-        last_enemy_move = now;
+        enemy_frame ^= 1;
+        last_enemy_move = tick;
+        sounds_march_step();
     }
 
-    // Enemy Shooting
-    if (absolute_time_diff_us(last_enemy_shot, now) >= enemy_shot_interval_us) {
-        int shooter = -1;
-        for (int tries = 0; tries < 10; tries++) {
-            int i = rand() % MAX_ENEMIES;
-            if (enemies[i].alive) {
-                shooter = i;
-                break;
-            }
+    // Enemy Shooting: the lowest invader of a random column
+    if (tick - last_enemy_shot >= (uint32_t)wave_interval(wave->fire, formation.alive_count, wave_size) &&
+        entities_count(ENTITY_ENEMY_SHOT) < wave->max_shots) {
+        int row, col;
+        if (formation_shooter(&formation, game_rand(), &row, &col)) {
+            int x = formation_cell_x(&formation, col) + INVADER_WIDTH / 2;
+            int y = formation_cell_y(&formation, row) + INVADER_HEIGHT;
+            if (entities_spawn(&enemy_shot_def, fix16_from_int(x), fix16_from_int(y),
+                               0, wave->shot_speed) != ENTITY_NONE)
+                last_enemy_shot = tick;
         }
+    }
+}
 
-        if (shooter >= 0) {
-            for (int b = 0; b < MAX_ENEMY_BULLETS; b++) {
-                if (!enemy_bullets[b].active) {
-                    enemy_bullets[b].x = enemies[shooter].x + 5;
-                    enemy_bullets[b].y = enemies[shooter].y + 6;
-                    enemy_bullets[b].active = true;
-                    last_enemy_shot = now;
-                    break;
-                }
-            }
+void enemies_draw(render_frame_t *frame) {
+    for (int row = 0; row < formation.rows; row++) {
+        const st7735_sprite_t *sprite = &sprite_invaders[wave->types[row] % INVADER_TYPES];
+        int y = formation_cell_y(&formation, row);
+        for (uint16_t mask = formation.alive[row]; mask; mask &= mask - 1) {
+            int col = __builtin_ctz(mask);
+            render_frame_add(frame, formation_cell_x(&formation, col), y, sprite->width, sprite->height,
+                             0, sprite, enemy_frame);
         }
     }
+    entities_draw(frame, ENTITY_ENEMY_SHOT);
+}
 
-    // Move Enemy Bullets
-    for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
-        if (!enemy_bullets[i].active) continue;
-        enemy_bullets[i].y += 4;
-        if (enemy_bullets[i].y > 160) enemy_bullets[i].active = false;
-    }
+bool enemies_check_bullet_hits(int bullet_x, int bullet_y) {
+    if (!formation_hit(&formation, bullet_x, bullet_y)) return false;
+
+    /* The hit cell, as formation_hit() found it */
+    int col = (bullet_x - formation.x) / formation.col_pitch;
+    int row = (bullet_y - formation.y) / formation.row_pitch;
+    particles_burst(formation_cell_x(&formation, col) + formation.cell_w / 2,
+                    formation_cell_y(&formation, row) + formation.cell_h / 2,
+                    INVADER_DEBRIS, FIX16(70), PARTICLE_RAMP_FIRE);
+    sounds_invader_killed();
+    return true;
 }
 
-void enemies_draw(void) {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (enemies[i].alive)
-            st7735_fill_rect(enemies[i].x, enemies[i].y, 10, 6, st7735_rgb(0, 255, 0));
-    }
-    for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
-        if (enemy_bullets[i].active)
-            st7735_fill_rect(enemy_bullets[i].x, enemy_bullets[i].y, 2, 6, st7735_rgb(255, 255, 0));
-    }
+uint32_t enemies_state_hash(uint32_t h) {
+    h = game_hash(h, &formation.x, sizeof(formation.x));
+    h = game_hash(h, &formation.y, sizeof(formation.y));
+    h = game_hash(h, formation.alive, sizeof(formation.alive));
+    h = game_hash(h, &wave_number, sizeof(wave_number));
+    h = game_hash(h, &next_wave, sizeof(next_wave));
+    h = game_hash(h, &pause_start, sizeof(pause_start));
+    h = game_hash(h, &enemy_dir, sizeof(enemy_dir));
+    h = game_hash(h, &enemy_frame, sizeof(enemy_frame));
+    h = game_hash(h, &last_enemy_move, sizeof(last_enemy_move));
+    return game_hash(h, &last_enemy_shot, sizeof(last_enemy_shot));
 }
 
-void enemies_check_bullet_hits(int bullet_x, int bullet_y, bool* bullet_active) {
-    for (int i = 0; i < MAX_ENEMIES; i++) {
-        if (!enemies[i].alive) continue;
-        if (bullet_x >= enemies[i].x && bullet_x <= enemies[i].x + 10 &&
-            bullet_y >= enemies[i].y && bullet_y <= enemies[i].y + 6) {
-            enemies[i].alive = false;
-            *bullet_active = false;
-            break;
-        }
-    }
+bool enemies_get_bounds(int *x, int *y, int *w, int *h) {
+    return formation_bounds(&formation, x, y, w, h);
 }
 
-bool enemies_check_player_hit(int player_x, int player_y, int player_width, int player_height) {
-    for (int i = 0; i < MAX_ENEMY_BULLETS; i++) {
-        if (!enemy_bullets[i].active) continue;
-        if (player_x < enemy_bullets[i].x + 2 &&
-            player_x + player_width > enemy_bullets[i].x &&
-            player_y < enemy_bullets[i].y + 6 &&
-            player_y + player_height > enemy_bullets[i].y) {
-            enemy_bullets[i].active = false;
-            return true;
-        }
-    }
-    return false;
+bool enemies_check_player_hit(broadphase_t *grid, int player_x, int player_y, int player_width, int player_height) {
+    uint16_t hit;
+    if (broadphase_query(grid, player_x, player_y, player_width, player_height,
+                         BROADPHASE_ENEMY_BULLET, &hit, 1) == 0)
+        return false;
+    entities_destroy(hit);
+    return true;
 }
@@ -0,0 +1,162 @@
+#include "game/entities.h"
+#include "game/game.h"
+#include "game/render_queue.h"
+
+#define SCREEN_WIDTH  128
+#define SCREEN_HEIGHT 160
+
+/* =======================
+   Components (dense, index < count)
+   ======================= */
+static fix16_t pos_x[ENTITY_MAX];
+static fix16_t pos_y[ENTITY_MAX];
+static fix16_t vel_x[ENTITY_MAX];
+static fix16_t vel_y[ENTITY_MAX];
+static uint8_t flags[ENTITY_MAX];             /* copy of def->flags, read every tick */
+static const entity_def_t *def[ENTITY_MAX];
+static entity_t handle_of[ENTITY_MAX];  /* dense index -> handle */
+static int count;
+
+/* Handles: dense index per handle, and a stack of free handles */
+static uint16_t dense_of[ENTITY_MAX];
+static entity_t free_handles[ENTITY_MAX];
+static int free_count;
+
+static entity_stats_t stats;
+
+void entities_init(void) {
+    /* Lowest handle on top, so handles are given out in order */
+    for (int i = 0; i < ENTITY_MAX; i++)
+        free_handles[i] = (entity_t)(ENTITY_MAX - 1 - i);
+    free_count = ENTITY_MAX;
+    count = 0;
+
+    /* Totals and the high-water mark survive a game restart */
+    for (int k = 0; k < ENTITY_KINDS; k++)
+        stats.per_kind[k] = 0;
+    stats.capacity = ENTITY_MAX;
+}
+
+entity_t entities_spawn(const entity_def_t *d, fix16_t x, fix16_t y, fix16_t vx, fix16_t vy) {
+    if (free_count == 0) {
+        stats.spawn_failed++;
+        return ENTITY_NONE;
+    }
+    entity_t e = free_handles[--free_count];
+    int i = count++;
+    pos_x[i] = x;
+    pos_y[i] = y;
+    vel_x[i] = vx;
+    vel_y[i] = vy;
+    flags[i] = d->flags;
+    def[i] = d;
+    handle_of[i] = e;
+    dense_of[e] = (uint16_t)i;
+
+    stats.spawned++;
+    stats.per_kind[d->kind]++;
+    if (count > stats.high_water) stats.high_water = (uint16_t)count;
+    return e;
+}
+
+void entities_destroy(entity_t e) {
+    /* A stale handle would swap out whichever entity holds its slot now */
+    if (!entities_alive(e)) return;
+    int i = dense_of[e];
+    stats.per_kind[def[i]->kind]--;
+
+    /* The last entity moves into the hole */
+    int last = --count;
+    pos_x[i] = pos_x[last];
+    pos_y[i] = pos_y[last];
+    vel_x[i] = vel_x[last];
+    vel_y[i] = vel_y[last];
+    flags[i] = flags[last];
+    def[i] = def[last];
+    handle_of[i] = handle_of[last];
+    dense_of[handle_of[i]] = (uint16_t)i;
+
+    free_handles[free_count++] = e;
+}
+
+int entities_count(entity_kind_t kind) {
+    return stats.per_kind[kind];
+}
+
+bool entities_alive(entity_t e) {
+    if (e >= ENTITY_MAX) return false;
+    int i = dense_of[e];
+    return i < count && handle_of[i] == e;
+}
+
+const entity_def_t *entities_def(entity_t e) {
+    return def[dense_of[e]];
+}
+
+fix16_t entities_x(entity_t e) {
+    return pos_x[dense_of[e]];
+}
+
+fix16_t entities_y(entity_t e) {
+    return pos_y[dense_of[e]];
+}
+
+void entities_set_x(entity_t e, fix16_t x) {
+    pos_x[dense_of[e]] = x;
+}
+
+void entities_set_velocity(entity_t e, fix16_t vx, fix16_t vy) {
+    vel_x[dense_of[e]] = vx;
+    vel_y[dense_of[e]] = vy;
+}
+
+/* =======================
+   Systems
+   ======================= */
+void entities_move(uint32_t dt_us) {
+    /* Backwards, so a destroy only moves entities already visited */
+    for (int i = count - 1; i >= 0; i--) {
+        pos_x[i] += fix16_distance(vel_x[i], dt_us);
+        pos_y[i] += fix16_distance(vel_y[i], dt_us);
+        if (!(flags[i] & ENTITY_CULL)) continue;
+        int x = fix16_to_int(pos_x[i]);
+        int y = fix16_to_int(pos_y[i]);
+        if (x < 0 || x > SCREEN_WIDTH || y < 0 || y > SCREEN_HEIGHT)
+            entities_destroy(handle_of[i]);
+    }
+}
+
+void entities_submit(broadphase_t *grid) {
+    for (int i = 0; i < count; i++) {
+        const entity_def_t *d = def[i];
+        if (d->layer)
+            broadphase_insert(grid, fix16_to_int(pos_x[i]), fix16_to_int(pos_y[i]),
+                              d->w, d->h, d->layer, handle_of[i]);
+    }
+}
+
+void entities_draw(render_frame_t *frame, entity_kind_t kind) {
+    for (int i = 0; i < count; i++) {
+        const entity_def_t *d = def[i];
+        if (d->kind != kind) continue;
+        render_frame_add(frame, fix16_to_int(pos_x[i]), fix16_to_int(pos_y[i]), d->w, d->h,
+                         d->color, d->sprite, 0);
+    }
+}
+
+uint32_t entities_state_hash(uint32_t h) {
+    h = game_hash(h, &count, sizeof(count));
+    h = game_hash(h, pos_x, count * sizeof(pos_x[0]));
+    h = game_hash(h, pos_y, count * sizeof(pos_y[0]));
+    h = game_hash(h, vel_x, count * sizeof(vel_x[0]));
+    h = game_hash(h, vel_y, count * sizeof(vel_y[0]));
+    h = game_hash(h, handle_of, count * sizeof(handle_of[0]));
+    for (int i = 0; i < count; i++)
+        h = game_hash(h, &def[i]->kind, 1);
+    return h;
+}
+
+void entities_get_stats(entity_stats_t *out) {
+    *out = stats;
+    out->active = (uint16_t)count;
+}
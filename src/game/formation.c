@@ -0,0 +1,123 @@
+#include "game/formation.h"
+
+/* Rebuilds the column caches from the alive masks */
+static void refresh_columns(formation_t *f) {
+    f->columns = 0;
+    f->column_count = 0;
+    for (int c = 0; c < FORMATION_MAX_COLS; c++) {
+        f->bottom[c] = -1;
+        for (int r = f->rows - 1; r >= 0; r--) {
+            if (formation_alive(f, r, c)) {
+                f->bottom[c] = (int8_t)r;
+                break;
+            }
+        }
+        if (f->bottom[c] >= 0) {
+            f->columns |= (uint16_t)(1u << c);
+            f->column_slot[c] = f->column_count;
+            f->column_list[f->column_count++] = (uint8_t)c;
+        }
+    }
+    if (f->columns == 0) {
+        f->leftmost = f->rightmost = -1;
+    } else {
+        f->leftmost = (int8_t)__builtin_ctz(f->columns);
+        f->rightmost = (int8_t)(31 - __builtin_clz(f->columns));
+    }
+}
+
+void formation_init(formation_t *f, int rows, int cols, int x, int y,
+                    int col_pitch, int row_pitch, int cell_w, int cell_h) {
+    if (rows > FORMATION_MAX_ROWS) rows = FORMATION_MAX_ROWS;
+    if (cols > FORMATION_MAX_COLS) cols = FORMATION_MAX_COLS;
+
+    f->x = x;
+    f->y = y;
+    f->rows = (uint8_t)rows;
+    f->cols = (uint8_t)cols;
+    f->col_pitch = (uint8_t)col_pitch;
+    f->row_pitch = (uint8_t)row_pitch;
+    f->cell_w = (uint8_t)cell_w;
+    f->cell_h = (uint8_t)cell_h;
+
+    uint16_t full = (uint16_t)((1u << cols) - 1u);
+    for (int r = 0; r < FORMATION_MAX_ROWS; r++)
+        f->alive[r] = r < rows ? full : 0;
+
+    f->alive_count = (uint16_t)(rows * cols);
+    refresh_columns(f);
+}
+
+void formation_set_shape(formation_t *f, const uint16_t *alive) {
+    uint16_t full = (uint16_t)((1u << f->cols) - 1u);
+    f->alive_count = 0;
+    for (int r = 0; r < f->rows; r++) {
+        f->alive[r] = alive[r] & full;
+        f->alive_count += (uint16_t)__builtin_popcount(f->alive[r]);
+    }
+    refresh_columns(f);
+}
+
+void formation_kill(formation_t *f, int row, int col) {
+    uint16_t bit = (uint16_t)(1u << col);
+    if (!(f->alive[row] & bit)) return;
+
+    f->alive[row] &= (uint16_t)~bit;
+    f->alive_count--;
+
+    /* Only the column's lowest invader changes its shooter */
+    if (row != f->bottom[col]) return;
+    for (int r = row - 1; r >= 0; r--) {
+        if (f->alive[r] & bit) {
+            f->bottom[col] = (int8_t)r;
+            return;
+        }
+    }
+
+    /* Column emptied: drop it from the list (the last entry takes its
+       slot) and recompute the edges */
+    f->bottom[col] = -1;
+    uint8_t slot = f->column_slot[col];
+    uint8_t last = f->column_list[--f->column_count];
+    f->column_list[slot] = last;
+    f->column_slot[last] = slot;
+    f->columns &= (uint16_t)~bit;
+    if (f->columns == 0) {
+        f->leftmost = f->rightmost = -1;
+    } else {
+        f->leftmost = (int8_t)__builtin_ctz(f->columns);
+        f->rightmost = (int8_t)(31 - __builtin_clz(f->columns));
+    }
+}
+
+bool formation_bounds(const formation_t *f, int *x, int *y, int *w, int *h) {
+    if (f->alive_count == 0) return false;
+
+    int top = 0, bottom = f->rows - 1;
+    while (!f->alive[top]) top++;
+    while (!f->alive[bottom]) bottom--;
+
+    *x = formation_left(f);
+    *y = formation_cell_y(f, top);
+    *w = formation_right(f) - *x + f->cell_w + 1;
+    *h = formation_cell_y(f, bottom) - *y + f->cell_h + 1;
+    return true;
+}
+
+bool formation_hit(formation_t *f, int px, int py) {
+    int dx = px - f->x;
+    int dy = py - f->y;
+    if (dx < 0 || dy < 0) return false;
+
+    int col = dx / f->col_pitch;
+    int row = dy / f->row_pitch;
+    if (col >= f->cols || row >= f->rows) return false;
+
+    /* Inside the invader, not the gap to the next one */
+    if (dx - col * f->col_pitch > f->cell_w) return false;
+    if (dy - row * f->row_pitch > f->cell_h) return false;
+
+    if (!formation_alive(f, row, col)) return false;
+    formation_kill(f, row, col);
+    return true;
+}
@@ -1,40 +1,68 @@
 #include "game/game.h"
 #include "game/gamestate.h"
+#include "game/profile.h"
 #include "demos/display.h"
 #include "hal/displays/st7735.h"
 #include "pico/time.h"
 #include <stdbool.h>
 #include <stdlib.h>
 #include "game/enemies.h"
+#include "game/entities.h"
+#include "game/particles.h"
+#include "game/shields.h"
+#include "game/sounds.h"
+#include "game/sprites.h"
 
 #define SCREEN_WIDTH 128
 #define PLAYER_Y     150
 #define PLAYER_WIDTH 10
+
+/* 1 = render through the low-memory strip renderer instead of framebuffers */
+#ifndef GAME_STRIP_RENDERER
+#define GAME_STRIP_RENDERER 0
+#endif
+
+/* 1 = drive the panel through the PIO interface (st7735_use_pio) instead
+   of the SPI block; not yet checked on hardware */
+#ifndef GAME_PIO_DISPLAY
+#define GAME_PIO_DISPLAY 0
+#endif
+
 #define MAX_BULLETS 50  // Kombiniert: alte Version hatte 50, neue 5 -> 50 für Flexibilität
 
-typedef struct {
-    int x, y;
-    bool active;
-} Bullet;
+/* Speeds in pixels per second (the old 50 ms frame moved 4 and 5 px) */
+#define PLAYER_SPEED FIX16(80)
+#define BULLET_SPEED FIX16(100)
+#define MENU_PUSH    FIX16(0.5) /* stick deflection that starts a game */
+#define SHOT_COOLDOWN_TICKS GAME_MS_TO_TICKS(40)
+#define SHIELD_DEBRIS 4 /* particles per shot stopped by a shield */
+
+static const entity_def_t player_def = {
+    ENTITY_PLAYER, PLAYER_WIDTH, 5, 0, 0, 0, &sprite_player
+};
+
+static const entity_def_t player_shot_def = {
+    ENTITY_PLAYER_SHOT, 2, 6, BROADPHASE_PLAYER_BULLET, ENTITY_CULL, 0xF800 /* red */, NULL
+};
 
 /* =======================
    Game variables
    ======================= */
-static int player_x = 60;
-static Bullet bullets[MAX_BULLETS];
-static absolute_time_t last_shot_time;
-static absolute_time_t last_enemy_move;
-static absolute_time_t last_enemy_shot;
+static entity_t player;
+static broadphase_t grid; /* rebuilt every tick from the moving objects */
+static uint32_t tick_count;
+static uint32_t last_shot_tick;
+static uint32_t rng_state = 1;
+static uint16_t round_count; /* game_reset() calls, tells the renderer to redraw */
 
-static uint32_t shot_cooldown_us = 40000;
-
-/* UI flags */
-static bool menu_drawn = false;
-static bool game_over_drawn = false;
+/* Renderer side: the static screen shown last */
+static uint8_t shown_screen = 0xFF;
+static uint16_t shown_round;
 
 /* =======================
    Forward declarations
    ======================= */
+static void game_step(fix16_t move, int fire);
 static void draw_menu(void);
 static void draw_game_over_screen(void);
 
@@ -44,107 +72,228 @@ static void draw_game_over_screen(void);
 void game_init(void) {
     init_display();
     st7735_begin();
+#if GAME_PIO_DISPLAY
+    display_use_pio();
+#endif
+#if GAME_STRIP_RENDERER
+    st7735_set_strip_mode(true);
+#else
+    st7735_set_framebuffer(true);
+    st7735_set_dirty_tracking(true);
+    st7735_set_pipelined(!GAME_DUAL_CORE); /* core 1 is the renderer otherwise */
+#endif
+    game_seed(time_us_32());
+    game_reset();
+}
+
+void game_reset(void) {
+    entities_init();
+    player = entities_spawn(&player_def, FIX16(60), fix16_from_int(PLAYER_Y), 0, 0);
     enemies_init();
-    st7735_fill_screen(st7735_rgb(0,0,0));
+    shields_init();
+    particles_init();
+    sounds_reset();
+
+    tick_count = 0;
+    last_shot_tick = 0;
+    round_count++;
 
-    srand(time_us_64());
-    last_shot_time = get_absolute_time();
+    set_state(GAMESTATE_MENU);
+}
 
-    for(int i=0;i<MAX_BULLETS;i++)
-        bullets[i].active = false;
+/* =======================
+   Randomness and state hash
+   ======================= */
+void game_seed(uint32_t seed) {
+    rng_state = seed ? seed : 1; /* xorshift must not start at 0 */
+}
 
-    menu_drawn = false;
-    game_over_drawn = false;
+uint32_t game_rand(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
 
-    set_state(GAMESTATE_MENU);
+uint32_t game_state_hash(void) {
+    uint32_t h = GAME_HASH_INIT;
+    uint32_t state = (uint32_t)get_state();
+    h = game_hash(h, &tick_count, sizeof(tick_count));
+    h = game_hash(h, &last_shot_tick, sizeof(last_shot_tick));
+    h = game_hash(h, &rng_state, sizeof(rng_state));
+    h = game_hash(h, &state, sizeof(state));
+    h = entities_state_hash(h);
+    h = shields_state_hash(h);
+    return enemies_state_hash(h);
 }
 
 /* =======================
-   Game Update
+   Game Tick
    ======================= */
-void game_update(int move_dir, int fire) {
-    absolute_time_t now = get_absolute_time();
+void game_tick(fix16_t move, int fire) {
+    PROFILE_BEGIN(PROFILE_TICK);
+    game_step(move, fire);
+    PROFILE_END(PROFILE_TICK);
+}
+
+static void game_step(fix16_t move, int fire) {
+    uint32_t tick = tick_count++;
 
     /* ---------- GAME OVER ---------- */
     if (get_state() == GAMESTATE_GAME_OVER) {
-        if (!game_over_drawn) {
-            draw_game_over_screen();
-            game_over_drawn = true;
-        }
-        if (move_dir < 0) {
-            game_init(); // Reset
+        if (move <= -MENU_PUSH) {
+            game_reset(); // Restart
         }
         return;
     }
 
     /* ---------- MENU ---------- */
     if (get_state() == GAMESTATE_MENU) {
-        if (!menu_drawn) {
-            draw_menu();
-            menu_drawn = true;
-        }
-        if (move_dir < 0) { // LEFT = START
-            st7735_fill_screen(st7735_rgb(0, 0, 0));
+        if (move <= -MENU_PUSH || move >= MENU_PUSH) { // LEFT (or RIGHT) = START
             set_state(GAMESTATE_PLAYING);
         }
         return;
     }
 
     /* ---------- PLAYING ---------- */
-    /* Player movement */
-    player_x += move_dir * 4;
-    if (player_x < 0) player_x = 0;
-    if (player_x > SCREEN_WIDTH - PLAYER_WIDTH)
-        player_x = SCREEN_WIDTH - PLAYER_WIDTH;
+    /* Player speed follows the stick deflection */
+    entities_set_velocity(player, fix16_mul(PLAYER_SPEED, move), 0);
+
+    /* Movement system: player and all shots. Shots fired below start
+       moving on the next tick. */
+    entities_move(GAME_TICK_US);
+    PROFILE_BEGIN(PROFILE_PARTICLES);
+    particles_update(GAME_TICK_US);
+    PROFILE_END(PROFILE_PARTICLES);
+    entities_set_x(player, fix16_clamp(entities_x(player), 0,
+                                       fix16_from_int(SCREEN_WIDTH - PLAYER_WIDTH)));
+    int player_px = fix16_to_int(entities_x(player));
 
     /* Player shooting */
-    if (fire && absolute_time_diff_us(last_shot_time, now) >= shot_cooldown_us) {
-        for (int i=0;i<MAX_BULLETS;i++){
-            if(!bullets[i].active){
-                bullets[i].x = player_x + PLAYER_WIDTH/2;
-                bullets[i].y = PLAYER_Y - 6;
-                bullets[i].active = true;
-                last_shot_time = now;
-                break;
-            }
+    if (fire && tick - last_shot_tick >= SHOT_COOLDOWN_TICKS &&
+        entities_count(ENTITY_PLAYER_SHOT) < MAX_BULLETS) {
+        if (entities_spawn(&player_shot_def, fix16_from_int(player_px + PLAYER_WIDTH/2),
+                           fix16_from_int(PLAYER_Y - 6), 0, -BULLET_SPEED) != ENTITY_NONE) {
+            last_shot_tick = tick;
+            sounds_shot();
         }
     }
 
-    /* Move bullets */
-    for(int i=0;i<MAX_BULLETS;i++){
-        if(!bullets[i].active) continue;
-        bullets[i].y -= 5;
-        if(bullets[i].y < 0) bullets[i].active = false;
-    }
+    /* Update enemies (they may fire too) */
+    PROFILE_BEGIN(PROFILE_ENEMIES);
+    enemies_update(tick);
+    PROFILE_END(PROFILE_ENEMIES);
 
-    /* Update enemies & bullets */
-    enemies_update();
+    PROFILE_BEGIN(PROFILE_COLLISIONS);
+    /* Broadphase: everything collidable into the grid */
+    broadphase_clear(&grid);
+    entities_submit(&grid);
+
+    /* Check bullet collisions with enemies: only bullets near the formation */
+    int fx, fy, fw, fh;
+    if (enemies_get_bounds(&fx, &fy, &fw, &fh)) {
+        uint16_t near[MAX_BULLETS];
+        int n = broadphase_query(&grid, fx, fy, fw, fh, BROADPHASE_PLAYER_BULLET, near, MAX_BULLETS);
+        for (int k = 0; k < n; k++) {
+            entity_t b = near[k];
+            if (enemies_check_bullet_hits(fix16_to_int(entities_x(b)), fix16_to_int(entities_y(b))))
+                entities_destroy(b);
+        }
 
-    /* Check bullet collisions with enemies */
-    for(int i=0;i<MAX_BULLETS;i++){
-        if(bullets[i].active)
-            enemies_check_bullet_hits(bullets[i].x, bullets[i].y, &bullets[i].active);
+        /* Invaders that reach the cannon's row win, as in the arcade */
+        if (fy + fh > PLAYER_Y)
+            set_state(GAMESTATE_GAME_OVER);
     }
 
     /* Check if player is hit */
-    if(enemies_check_player_hit(player_x, PLAYER_Y, PLAYER_WIDTH, 5)) {
+    if(enemies_check_player_hit(&grid, player_px, PLAYER_Y, PLAYER_WIDTH, 5)) {
+        sounds_player_hit();
         set_state(GAMESTATE_GAME_OVER);
     }
 
-    /* ---------- Render ---------- */
-    st7735_fill_screen(st7735_rgb(0,0,0));
+    /* Shots in the shield band erode the shields and are used up; skip
+       those already spent above */
+    PROFILE_BEGIN(PROFILE_SHIELDS);
+    int sx, sy, sw, sh;
+    shields_get_bounds(&sx, &sy, &sw, &sh);
+    uint16_t shots[ENTITY_MAX];
+    int n = broadphase_query(&grid, sx, sy, sw, sh, BROADPHASE_PLAYER_BULLET | BROADPHASE_ENEMY_BULLET,
+                             shots, ENTITY_MAX);
+    for (int k = 0; k < n; k++) {
+        entity_t s = shots[k];
+        if (!entities_alive(s)) continue;
+        const entity_def_t *d = entities_def(s);
+        int x = fix16_to_int(entities_x(s));
+        int y = fix16_to_int(entities_y(s));
+        int dir = d->kind == ENTITY_PLAYER_SHOT ? -1 : 1;
+        if (shields_hit(x, y, d->w, d->h, dir)) {
+            particles_burst(x, dir < 0 ? y : y + d->h, SHIELD_DEBRIS, FIX16(40), PARTICLE_RAMP_DEBRIS);
+            entities_destroy(s);
+        }
+    }
+    PROFILE_END(PROFILE_SHIELDS);
+    PROFILE_END(PROFILE_COLLISIONS);
+}
 
-    /* Draw player */
-    st7735_fill_rect(player_x, PLAYER_Y, PLAYER_WIDTH, 5, st7735_rgb(255,255,255));
+/* =======================
+   Game Render
+   ======================= */
+void game_render(void) {
+    static render_frame_t frame;
+    game_build_frame(&frame);
+    game_draw_frame(&frame);
+}
+
+void game_build_frame(render_frame_t *frame) {
+    frame->tick = tick_count;
+    frame->round = round_count;
+    frame->screen = (uint8_t)get_state();
+    frame->count = 0;
+    frame->tile_count = 0;
+    frame->point_count = 0;
+    if (get_state() != GAMESTATE_PLAYING) return;
+
+    /* Shields, player and bullets, enemies and their bullets, then debris */
+    shields_draw(frame);
+    entities_draw(frame, ENTITY_PLAYER);
+    entities_draw(frame, ENTITY_PLAYER_SHOT);
+    enemies_draw(frame);
+    particles_draw(frame);
+}
+
+void game_draw_frame(const render_frame_t *frame) {
+    /* Menu and game over are drawn once per visit */
+    if (frame->screen != GAMESTATE_PLAYING) {
+        if (frame->screen != shown_screen || frame->round != shown_round) {
+            if (frame->screen == GAMESTATE_MENU)
+                draw_menu();
+            else
+                draw_game_over_screen();
+        }
+        shown_screen = frame->screen;
+        shown_round = frame->round;
+        return;
+    }
+    shown_screen = frame->screen;
 
-    /* Draw bullets */
-    for(int i=0;i<MAX_BULLETS;i++){
-        if(bullets[i].active)
-            st7735_fill_rect(bullets[i].x, bullets[i].y, 2, 6, st7735_rgb(255,0,0));
+    /* Erases only what the last frame drew */
+    PROFILE_BEGIN(PROFILE_DRAW);
+    st7735_begin_frame(st7735_rgb(0,0,0));
+    for (int i = 0; i < frame->count; i++) {
+        const render_command_t *c = &frame->commands[i];
+        if (c->sprite)
+            st7735_draw_sprite_tagged(c->x, c->y, c->sprite, c->frame, c->tag);
+        else
+            st7735_fill_rect(c->x, c->y, c->w, c->h, c->color);
     }
+    st7735_draw_points(frame->points, frame->point_count);
+    PROFILE_END(PROFILE_DRAW);
 
-    /* Draw enemies */
-    enemies_draw();
+    /* Send the regions that changed since the last frame */
+    PROFILE_BEGIN(PROFILE_PRESENT);
+    st7735_present();
+    PROFILE_END(PROFILE_PRESENT);
 }
 
 /* =======================
@@ -154,10 +303,12 @@ static void draw_menu(void) {
     st7735_fill_screen(st7735_rgb(0,0,0));
     st7735_draw_string(20, 40, "SPACE INVADERS", st7735_rgb(255,255,255), 0);
     st7735_draw_string(20, 60, "LEFT = START", st7735_rgb(255,255,255), 0);
+    st7735_present();
 }
 
 static void draw_game_over_screen(void) {
     st7735_fill_screen(st7735_rgb(0,0,0));
     st7735_draw_string(30, 40, "GAME OVER", st7735_rgb(255,0,0), 0);
     st7735_draw_string(10, 70, "LEFT = RESTART", st7735_rgb(255,255,255), 0);
+    st7735_present();
 }
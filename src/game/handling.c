@@ -3,14 +3,173 @@
 #include "hardware/gpio.h"
 #include "game/game.h"
 #include "game/gamestate.h"
+#include "game/handling.h"
+#include "game/profile.h"
+#include "game/entities.h"
+#include "game/replay.h"
+#include "game/render_queue.h"
+#include "game/audio.h"
+#include "hal/audio/pwm_audio.h"
 #include "hal/controls/joystick.h"
 #include "demos/joystick.h"
+#include "hal/displays/st7735.h"
+#include "pico/multicore.h"
+#include <stdio.h>
 
 #define LEFT_BUTTON_PIN   15
 #define BOTTOM_BUTTON_PIN 14
 #define TOP_BUTTON_PIN    10
 #define RIGHT_BUTTON_PIN  11
 
+#define FRAME_REPORT_INTERVAL_US 1000000
+#define MAX_CATCHUP_TICKS        8
+
+/* 1 = record and replay runs over the UART: 'r' starts recording from a
+   fresh seed, 's' stops and prints the stream as hex lines, 'l' plays the
+   last recording back and compares the final state hash */
+#ifndef GAME_REPLAY
+#define GAME_REPLAY 1
+#endif
+#define REPLAY_BUFFER_SIZE 8192 /* ~30 min of held input, ~1 min of constant changes */
+
+/* 1 = sound as PWM on AUDIO_PIN (RC low-pass to an amplifier). The DMA
+   interrupt that mixes runs on the render core with GAME_DUAL_CORE, so
+   mixing never takes time from the simulation. */
+#ifndef GAME_AUDIO
+#define GAME_AUDIO 1
+#endif
+#define AUDIO_PIN 20
+
+#if GAME_AUDIO
+static void audio_start(void)
+{
+    if (!pwm_audio_init(AUDIO_PIN, AUDIO_SAMPLE_RATE, audio_mix))
+    {
+        printf("Audio: no free DMA timer or channels, sound off\n");
+    }
+}
+#endif
+
+static handling_loop_stats_t _loop_stats;
+
+#if GAME_DUAL_CORE
+static render_queue_t _render_queue;
+
+// Core 1: draws every published frame, oldest first
+static void render_core_main(void)
+{
+#if GAME_AUDIO
+    audio_start(); /* the refill interrupt runs on this core */
+#endif
+    while (true)
+    {
+        const render_frame_t *frame = render_queue_peek(&_render_queue);
+        if (!frame)
+        {
+            tight_loop_contents();
+            continue;
+        }
+        game_draw_frame(frame);
+        render_queue_release(&_render_queue);
+    }
+}
+#endif
+
+#if GAME_REPLAY
+static uint8_t _replay_buf[REPLAY_BUFFER_SIZE];
+static size_t _replay_len;
+static uint32_t _replay_ticks;
+
+static void replay_dump(void)
+{
+    for (size_t i = 0; i < _replay_len; i += 32)
+    {
+        printf("REPLAY ");
+        for (size_t j = i; j < i + 32 && j < _replay_len; j++)
+        {
+            printf("%02x", _replay_buf[j]);
+        }
+        printf("\n");
+    }
+}
+
+static void replay_command(int c)
+{
+    uint32_t seed;
+    switch (c)
+    {
+    case 'r':
+        seed = time_us_32();
+        replay_record_start(_replay_buf, sizeof(_replay_buf), seed);
+        game_seed(seed);
+        game_reset();
+        _replay_ticks = 0;
+        printf("Replay: recording, seed %08lx\n", (unsigned long)seed);
+        break;
+    case 's':
+        if (!replay_recording())
+        {
+            break;
+        }
+        _replay_len = replay_record_finish(game_state_hash());
+        if (_replay_len == 0)
+        {
+            printf("Replay: buffer full, recording lost\n");
+            break;
+        }
+        printf("Replay: %lu ticks in %u bytes, state %08lx\n", (unsigned long)_replay_ticks,
+               (unsigned)_replay_len, (unsigned long)game_state_hash());
+        replay_dump();
+        break;
+    case 'l':
+        if (_replay_len == 0 || !replay_play_start(_replay_buf, _replay_len, &seed))
+        {
+            printf("Replay: nothing recorded\n");
+            break;
+        }
+        game_seed(seed);
+        game_reset();
+        _replay_ticks = 0;
+        printf("Replay: playing, seed %08lx\n", (unsigned long)seed);
+        break;
+    }
+}
+
+/* Swaps the live input for the recorded one while a replay runs and
+   records it while recording. Returns false when a replay just ended. */
+static bool replay_input(int8_t *move, bool *fire)
+{
+    if (replay_playing())
+    {
+        if (replay_play_tick(move, fire))
+        {
+            _replay_ticks++;
+            return true;
+        }
+        uint32_t ticks, expected;
+        uint32_t hash = game_state_hash();
+        if (replay_expected(&ticks, &expected))
+        {
+            printf("Replay: %lu/%lu ticks, state %08lx, %s\n", (unsigned long)_replay_ticks,
+                   (unsigned long)ticks, (unsigned long)hash, hash == expected ? "match" : "MISMATCH");
+        }
+        return false;
+    }
+    if (replay_recording())
+    {
+        if (replay_record_tick(*move, *fire))
+        {
+            _replay_ticks++;
+        }
+        else
+        {
+            replay_command('s'); /* buffer full: finish what fits */
+        }
+    }
+    return true;
+}
+#endif
+
 void handling_execute(void)
 {
     joystick_init_simple_center();
@@ -34,25 +193,216 @@ void handling_execute(void)
     gpio_pull_up(TOP_BUTTON_PIN);
     gpio_pull_up(BOTTOM_BUTTON_PIN);
 
+#if GAME_AUDIO
+    audio_init();
+#if !GAME_DUAL_CORE
+    audio_start();
+#endif
+    pwm_audio_stats_t audio_start_stats = {0};
+#endif
+
+#if GAME_DUAL_CORE
+    render_queue_init(&_render_queue);
+    multicore_launch_core1(render_core_main);
+    render_queue_stats_t queue_start_stats = {0};
+#endif
+
+    /* Fixed timestep: the game advances in GAME_TICK_US steps. When the
+       loop falls behind, it runs the overdue ticks back to back before
+       rendering again, up to MAX_CATCHUP_TICKS; anything beyond that is
+       dropped so a long stall cannot turn into a burst of catch-up. */
+    absolute_time_t next_tick = get_absolute_time();
+
+    /* Per-second report */
+    uint32_t report_ticks = 0;
+    uint32_t report_frames = 0;
+    uint64_t tick_us_sum = 0;
+    uint64_t render_us_sum = 0;
+    handling_loop_stats_t report_start_stats = _loop_stats;
+    uint32_t spi_bytes_start = st7735_get_bytes_sent();
+    absolute_time_t report_start = get_absolute_time();
+#if GAME_PROFILE && GAME_PROFILE_REPORT_MS
+    absolute_time_t profile_report_at = make_timeout_time_ms(GAME_PROFILE_REPORT_MS);
+#endif
+
     while (true)
     {
+        PROFILE_BEGIN(PROFILE_LOOP);
+        PROFILE_BEGIN(PROFILE_INPUT);
         joystick_read(&event);
 
-        int move = 0;
-        int fire = 0;
+        // Stick deflection sets the speed (the X axis is mounted
+        // inverted); buttons move at full speed. Quantized like a
+        // recording, so live play and its replay see the same input.
+        int8_t move_q = replay_quantize(fix16_from_float(-event.x_norm));
+        bool fire = false;
+
+        if (!gpio_get(LEFT_BUTTON_PIN))  move_q = -127;
+        if (!gpio_get(RIGHT_BUTTON_PIN)) move_q =  127;
+        if (!gpio_get(TOP_BUTTON_PIN))   fire = true;
+        PROFILE_END(PROFILE_INPUT);
+
+        int uart = getchar_timeout_us(0);
+#if GAME_REPLAY
+        if (uart >= 0)
+        {
+            replay_command(uart);
+        }
+#endif
+        (void)uart;
+
+        int ran = 0;
+        absolute_time_t now = get_absolute_time();
+        while (absolute_time_diff_us(next_tick, now) >= 0) {
+            if (ran == MAX_CATCHUP_TICKS) {
+                /* Too far behind: give up on the backlog */
+                uint32_t behind = absolute_time_diff_us(next_tick, now) / GAME_TICK_US + 1;
+                _loop_stats.dropped_ticks += behind;
+                next_tick = delayed_by_us(now, GAME_TICK_US);
+                break;
+            }
+            if (ran > 0) {
+                _loop_stats.missed_deadlines++;
+            }
+
+#if GAME_REPLAY
+            int8_t tick_move = move_q;
+            bool tick_fire = fire;
+            if (!replay_input(&tick_move, &tick_fire)) {
+                tick_move = move_q; /* replay over, live input again */
+                tick_fire = fire;
+            }
+            fix16_t move = replay_move(tick_move);
+            int fire_now = tick_fire;
+#else
+            fix16_t move = replay_move(move_q);
+            int fire_now = fire;
+#endif
 
-        if (event.x_norm < -0.5f) move = 1;
-        if (event.x_norm >  0.5f) move =  -1;
+            absolute_time_t tick_start = get_absolute_time();
+            game_tick(move, fire_now);
+            tick_us_sum += absolute_time_diff_us(tick_start, get_absolute_time());
 
-        if (!gpio_get(LEFT_BUTTON_PIN))  move = -1;
-        if (!gpio_get(RIGHT_BUTTON_PIN)) move =  1;
-        if (!gpio_get(TOP_BUTTON_PIN))   fire = 1;
+            _loop_stats.ticks++;
+            report_ticks++;
+            ran++;
+            next_tick = delayed_by_us(next_tick, GAME_TICK_US);
+            now = get_absolute_time();
+        }
 
-        if (get_state() == GAMESTATE_MENU && move != 0) {
-            set_state(GAMESTATE_PLAYING);
+        /* Render only when the state changed, and only if the display has
+           finished the previous frame; otherwise the tick rate would be
+           pulled down to the panel's refresh rate. */
+        if (ran > 0) {
+#if GAME_DUAL_CORE
+            /* Core 0 only snapshots the frame; a full queue drops it */
+            render_frame_t *frame = render_queue_begin(&_render_queue);
+            if (!frame) {
+                _loop_stats.skipped_frames++;
+            } else {
+                absolute_time_t render_start = get_absolute_time();
+                game_build_frame(frame);
+                render_queue_publish(&_render_queue);
+                render_us_sum += absolute_time_diff_us(render_start, get_absolute_time());
+                _loop_stats.frames++;
+                report_frames++;
+            }
+#else
+            if (st7735_is_busy()) {
+                _loop_stats.skipped_frames++;
+            } else {
+                absolute_time_t render_start = get_absolute_time();
+                game_render();
+                render_us_sum += absolute_time_diff_us(render_start, get_absolute_time());
+                _loop_stats.frames++;
+                report_frames++;
+            }
+#endif
         }
+        PROFILE_END(PROFILE_LOOP);
 
-        game_update(move, fire);
-        sleep_ms(50);
+#if GAME_PROFILE
+        /* Phase histograms: periodically, or when 'p' arrives on the UART */
+        bool profile_due = uart == 'p';
+#if GAME_PROFILE_REPORT_MS
+        if (time_reached(profile_report_at)) {
+            profile_due = true;
+            profile_report_at = make_timeout_time_ms(GAME_PROFILE_REPORT_MS);
+        }
+#endif
+        if (profile_due) {
+            profile_report();
+        }
+#endif
+
+        int64_t elapsed_us = absolute_time_diff_us(report_start, get_absolute_time());
+        if (elapsed_us >= FRAME_REPORT_INTERVAL_US && report_ticks > 0 && report_frames > 0) {
+            uint32_t spi_bytes = st7735_get_bytes_sent() - spi_bytes_start;
+            entity_stats_t pool;
+            entities_get_stats(&pool);
+            printf("Loop: %lu ticks/s, %lu fps, %lu us tick, %lu us render, "
+                   "%lu missed, %lu dropped, %lu skipped, %lu SPI bytes/frame, "
+                   "%u/%u entities (peak %u)\n",
+                   (unsigned long)(report_ticks * 1000000ull / elapsed_us),
+                   (unsigned long)(report_frames * 1000000ull / elapsed_us),
+                   (unsigned long)(tick_us_sum / report_ticks),
+                   (unsigned long)(render_us_sum / report_frames),
+                   (unsigned long)(_loop_stats.missed_deadlines - report_start_stats.missed_deadlines),
+                   (unsigned long)(_loop_stats.dropped_ticks - report_start_stats.dropped_ticks),
+                   (unsigned long)(_loop_stats.skipped_frames - report_start_stats.skipped_frames),
+                   (unsigned long)(spi_bytes / report_frames),
+                   pool.active, pool.capacity, pool.high_water);
+#if !GAME_DUAL_CORE
+            /* Core 1 only runs the display pipeline without the render queue (see game_init) */
+            st7735_pipeline_stats_t pipeline;
+            st7735_get_pipeline_stats(&pipeline);
+            printf("Display pipeline: %lu frames, %lu stalls (%lu us waited)\n",
+                   (unsigned long)pipeline.frames_presented, (unsigned long)pipeline.frames_stalled,
+                   (unsigned long)pipeline.stall_us);
+#endif
+#if GAME_DUAL_CORE
+            /* "render" above is the frame snapshot on core 0; drawing and
+               SPI happen on core 1 */
+            render_queue_stats_t queue;
+            render_queue_get_stats(&_render_queue, &queue);
+            printf("Render queue: depth %d (max %u of %d), %lu frames drawn, %lu producer stalls\n",
+                   render_queue_depth(&_render_queue), queue.depth_max, RENDER_QUEUE_DEPTH,
+                   (unsigned long)(queue.rendered - queue_start_stats.rendered),
+                   (unsigned long)(queue.stalls - queue_start_stats.stalls));
+            queue_start_stats = queue;
+#endif
+#if GAME_AUDIO
+            /* Mixing time per buffer against the time the buffer plays */
+            pwm_audio_stats_t out;
+            pwm_audio_get_stats(&out);
+            audio_stats_t mix;
+            audio_get_stats(&mix);
+            uint32_t buffers = out.buffers - audio_start_stats.buffers;
+            if (buffers > 0) {
+                uint32_t avg_us = (uint32_t)((out.fill_us_total - audio_start_stats.fill_us_total) / buffers);
+                printf("Audio: %lu us mix avg, %lu max per %d samples (%lu%% of %lu us), "
+                       "%lu late, %lu dropped, %lu clipped\n",
+                       (unsigned long)avg_us, (unsigned long)out.fill_us_max, PWM_AUDIO_BUFFER_SAMPLES,
+                       (unsigned long)(avg_us * 100 / out.budget_us), (unsigned long)out.budget_us,
+                       (unsigned long)(out.over_budget - audio_start_stats.over_budget),
+                       (unsigned long)mix.dropped, (unsigned long)mix.clipped);
+            }
+            audio_start_stats = out;
+#endif
+            report_ticks = 0;
+            report_frames = 0;
+            tick_us_sum = 0;
+            render_us_sum = 0;
+            report_start_stats = _loop_stats;
+            spi_bytes_start = st7735_get_bytes_sent();
+            report_start = get_absolute_time();
+        }
+
+        sleep_until(next_tick);
     }
 }
+
+void handling_get_loop_stats(handling_loop_stats_t *stats)
+{
+    *stats = _loop_stats;
+}
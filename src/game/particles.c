@@ -0,0 +1,124 @@
+#include "game/particles.h"
+#include "game/render_queue.h"
+
+#define SCREEN_WIDTH  128
+#define SCREEN_HEIGHT 160
+
+#define PARTICLE_GRAVITY FIX16(120) /* px/s^2 */
+
+/* =======================
+   Components (dense, index < count)
+   ======================= */
+static fix16_t pos_x[PARTICLE_MAX];
+static fix16_t pos_y[PARTICLE_MAX];
+static fix16_t vel_x[PARTICLE_MAX];
+static fix16_t vel_y[PARTICLE_MAX];
+static uint8_t life[PARTICLE_MAX];   /* ticks left, 1..PARTICLE_LIFE_MAX */
+static uint8_t ramp[PARTICLE_MAX];   /* particle_ramp_t */
+static int count;
+
+static particle_stats_t stats;
+static uint32_t rng_state;
+
+/* Colors from burnt out (0) to fresh (7) */
+static const uint16_t ramps[PARTICLE_RAMPS][8] = {
+    [PARTICLE_RAMP_FIRE]   = { 0x6000, 0x9000, 0xC000, 0xF800, 0xFB00, 0xFD20, 0xFFE0, 0xFFFF },
+    [PARTICLE_RAMP_DEBRIS] = { 0x0200, 0x0280, 0x0300, 0x03E0, 0x0480, 0x05E0, 0x07E0, 0x87F0 },
+};
+
+/* Unit vectors every 22.5 degrees */
+static const fix16_t dir_x[16] = {
+    FIX16(1.0),  FIX16(0.9239),  FIX16(0.7071),  FIX16(0.3827),
+    FIX16(0.0),  FIX16(-0.3827), FIX16(-0.7071), FIX16(-0.9239),
+    FIX16(-1.0), FIX16(-0.9239), FIX16(-0.7071), FIX16(-0.3827),
+    FIX16(0.0),  FIX16(0.3827),  FIX16(0.7071),  FIX16(0.9239),
+};
+#define DIR_Y(i) dir_x[((i) + 12) & 15]
+
+/* xorshift, kept apart from game_rand() so debris never shifts gameplay */
+static uint32_t particle_rand(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
+
+void particles_init(void) {
+    count = 0;
+    rng_state = 0x9E3779B9u;
+    stats.capacity = PARTICLE_MAX;
+}
+
+void particles_burst(int x, int y, int n, fix16_t speed, particle_ramp_t r) {
+    if (n > PARTICLE_MAX - count) {
+        stats.dropped += (uint32_t)(n - (PARTICLE_MAX - count));
+        n = PARTICLE_MAX - count;
+    }
+    fix16_t px = fix16_from_int(x);
+    fix16_t py = fix16_from_int(y);
+    uint32_t spread = (uint32_t)(speed - speed / 4) + 1;
+    for (int k = 0; k < n; k++) {
+        uint32_t bits = particle_rand();
+        int d = bits & 15;
+        fix16_t s = speed / 4 + (fix16_t)((bits >> 4) % spread);
+        int i = count++;
+        pos_x[i] = px;
+        pos_y[i] = py;
+        vel_x[i] = fix16_mul(dir_x[d], s);
+        vel_y[i] = fix16_mul(DIR_Y(d), s);
+        life[i] = (uint8_t)(PARTICLE_LIFE_MAX / 2 + (bits >> 24) % (PARTICLE_LIFE_MAX / 2 + 1));
+        ramp[i] = (uint8_t)r;
+    }
+
+    stats.spawned += (uint32_t)n;
+    if (count > stats.high_water) stats.high_water = (uint16_t)count;
+}
+
+/* The last particle takes the place of a dead one */
+static inline void remove_at(int i) {
+    int last = --count;
+    pos_x[i] = pos_x[last];
+    pos_y[i] = pos_y[last];
+    vel_x[i] = vel_x[last];
+    vel_y[i] = vel_y[last];
+    life[i] = life[last];
+    ramp[i] = ramp[last];
+}
+
+void particles_update(uint32_t dt_us) {
+    fix16_t fall = fix16_distance(PARTICLE_GRAVITY, dt_us);
+    /* Backwards, so a removal only moves particles already visited */
+    for (int i = count - 1; i >= 0; i--) {
+        if (--life[i] == 0) {
+            remove_at(i);
+            continue;
+        }
+        pos_x[i] += fix16_distance(vel_x[i], dt_us);
+        pos_y[i] += fix16_distance(vel_y[i], dt_us);
+        vel_y[i] += fall;
+        int x = fix16_to_int(pos_x[i]);
+        int y = fix16_to_int(pos_y[i]);
+        if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT)
+            remove_at(i);
+    }
+}
+
+void particles_draw(render_frame_t *frame) {
+    st7735_point_t *p = frame->points;
+    for (int i = 0; i < count; i++) {
+        p[i].x = (uint8_t)fix16_to_int(pos_x[i]);
+        p[i].y = (uint8_t)fix16_to_int(pos_y[i]);
+        p[i].color = ramps[ramp[i]][life[i] >> 3];
+    }
+    frame->point_count = (uint16_t)count;
+}
+
+int particles_count(void) {
+    return count;
+}
+
+void particles_get_stats(particle_stats_t *out) {
+    *out = stats;
+    out->active = (uint16_t)count;
+}
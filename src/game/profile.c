@@ -0,0 +1,171 @@
+#include "game/profile.h"
+
+#if GAME_PROFILE
+
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+/* =======================
+   Histogram layout
+   =======================
+   Values below 8 us get one bucket each. Above that, every power of two
+   is split into 8 buckets, so a bucket spans at most 1/8 of its value.
+   The last bucket collects everything from ~2 s up. */
+#define SUB_BUCKETS   8
+#define SUB_BITS      3
+#define MAX_OCTAVE    21
+#define BUCKET_COUNT  (SUB_BUCKETS + (MAX_OCTAVE - SUB_BITS) * SUB_BUCKETS)
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[BUCKET_COUNT];
+} profile_histogram_t;
+
+/* =======================
+   Per-core sets
+   =======================
+   With GAME_DUAL_CORE, draw and present are recorded on core 1 while
+   core 0 reports, so each core writes only its own set. A writer makes
+   its sequence number odd while it updates; the reporter copies a
+   histogram and retries if the number was odd or moved. A reset only
+   bumps the window; each core clears its own set on its next record (a
+   sample landing between a report and its reset is dropped with it). */
+#define PROFILE_CORES 2
+
+static profile_histogram_t histograms[PROFILE_CORES][PROFILE_PHASE_COUNT];
+static volatile uint32_t sequence[PROFILE_CORES];
+static volatile uint32_t window;                     /* written by the reporter */
+static volatile uint32_t core_window[PROFILE_CORES]; /* window each set belongs to */
+
+static const char *const phase_names[PROFILE_PHASE_COUNT] = {
+    [PROFILE_INPUT]      = "input",
+    [PROFILE_TICK]       = "tick",
+    [PROFILE_ENEMIES]    = "enemies",
+    [PROFILE_PARTICLES]  = "particles",
+    [PROFILE_COLLISIONS] = "collide",
+    [PROFILE_SHIELDS]    = "shields",
+    [PROFILE_DRAW]       = "draw",
+    [PROFILE_PRESENT]    = "present",
+    [PROFILE_LOOP]       = "loop",
+};
+
+static int bucket_index(uint32_t us) {
+    if (us < SUB_BUCKETS) return (int)us;
+    int octave = 31 - __builtin_clz(us);
+    if (octave >= MAX_OCTAVE) return BUCKET_COUNT - 1;
+    int sub = (int)(us >> (octave - SUB_BITS)) & (SUB_BUCKETS - 1);
+    return SUB_BUCKETS + (octave - SUB_BITS) * SUB_BUCKETS + sub;
+}
+
+/* Largest value that still falls into bucket i */
+static uint32_t bucket_upper(int i) {
+    if (i < SUB_BUCKETS) return (uint32_t)i;
+    if (i == BUCKET_COUNT - 1) return UINT32_MAX;
+    int octave = (i - SUB_BUCKETS) / SUB_BUCKETS + SUB_BITS;
+    uint32_t sub = (uint32_t)((i - SUB_BUCKETS) % SUB_BUCKETS);
+    return ((SUB_BUCKETS + sub + 1) << (octave - SUB_BITS)) - 1;
+}
+
+/* =======================
+   Recording
+   ======================= */
+static void clear(profile_histogram_t *h) {
+    h->count = 0;
+    h->min_us = 0;
+    h->max_us = 0;
+    h->sum_us = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) h->buckets[i] = 0;
+}
+
+void profile_record(profile_phase_t phase, uint32_t us) {
+    uint core = get_core_num();
+    sequence[core]++;
+    __dmb(); /* odd before the set changes */
+    if (core_window[core] != window) {
+        for (int p = 0; p < PROFILE_PHASE_COUNT; p++) clear(&histograms[core][p]);
+        core_window[core] = window;
+    }
+    profile_histogram_t *h = &histograms[core][phase];
+    if (h->count == 0 || us < h->min_us) h->min_us = us;
+    if (us > h->max_us) h->max_us = us;
+    h->count++;
+    h->sum_us += us;
+    h->buckets[bucket_index(us)]++;
+    __dmb(); /* the set before even again */
+    sequence[core]++;
+}
+
+void profile_reset(void) {
+    window++;
+}
+
+/* A consistent copy of one core's histogram; false if the core has not
+   recorded anything since the last reset */
+static bool snapshot(int core, profile_phase_t phase, profile_histogram_t *out) {
+    uint32_t seq;
+    bool current;
+    do {
+        seq = sequence[core];
+        __dmb();
+        current = core_window[core] == window;
+        *out = histograms[core][phase];
+        __dmb();
+    } while ((seq & 1) || sequence[core] != seq);
+    return current;
+}
+
+/* =======================
+   Summary
+   ======================= */
+void profile_get_summary(profile_phase_t phase, profile_summary_t *summary) {
+    /* Both cores' histograms of the phase merged */
+    static profile_histogram_t merged, part;
+    clear(&merged);
+    for (int c = 0; c < PROFILE_CORES; c++) {
+        if (!snapshot(c, phase, &part) || part.count == 0) continue;
+        if (merged.count == 0 || part.min_us < merged.min_us) merged.min_us = part.min_us;
+        if (part.max_us > merged.max_us) merged.max_us = part.max_us;
+        merged.count += part.count;
+        merged.sum_us += part.sum_us;
+        for (int i = 0; i < BUCKET_COUNT; i++) merged.buckets[i] += part.buckets[i];
+    }
+    const profile_histogram_t *h = &merged;
+    summary->count = h->count;
+    summary->min_us = h->min_us;
+    summary->max_us = h->max_us;
+    summary->avg_us = h->count ? (uint32_t)(h->sum_us / h->count) : 0;
+    summary->p99_us = 0;
+    if (h->count == 0) return;
+
+    /* First bucket that holds the 99th percentile sample */
+    uint32_t target = h->count - h->count / 100;
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint32_t upper = bucket_upper(i);
+            summary->p99_us = upper < h->max_us ? upper : h->max_us;
+            break;
+        }
+    }
+}
+
+void profile_report(void) {
+    printf("Profile (us)   count    min    avg    p99    max\n");
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        profile_summary_t s;
+        profile_get_summary((profile_phase_t)p, &s);
+        if (s.count == 0) continue;
+        printf("  %-10s %8lu %6lu %6lu %6lu %6lu\n", phase_names[p],
+               (unsigned long)s.count, (unsigned long)s.min_us,
+               (unsigned long)s.avg_us, (unsigned long)s.p99_us,
+               (unsigned long)s.max_us);
+    }
+    profile_reset();
+}
+
+#endif /* GAME_PROFILE */
@@ -0,0 +1,52 @@
+#include "game/render_queue.h"
+#include "pico/stdlib.h"
+
+/* The indices count up forever; slot = index % depth, and tail - head is
+   the number of frames in flight. A barrier sits between writing a slot
+   and moving the index that hands it over, on both sides. */
+
+void render_queue_init(render_queue_t *q) {
+    q->head = 0;
+    q->tail = 0;
+    q->stats = (render_queue_stats_t){0};
+}
+
+render_frame_t *render_queue_begin(render_queue_t *q) {
+    if (q->tail - q->head == RENDER_QUEUE_DEPTH) {
+        q->stats.stalls++;
+        return NULL;
+    }
+    render_frame_t *frame = &q->slots[q->tail % RENDER_QUEUE_DEPTH];
+    frame->count = 0;
+    frame->tile_count = 0;
+    frame->point_count = 0;
+    return frame;
+}
+
+void render_queue_publish(render_queue_t *q) {
+    __dmb(); /* frame contents before the new tail */
+    q->tail++;
+    q->stats.published++;
+    uint32_t depth = q->tail - q->head;
+    if (depth > q->stats.depth_max) q->stats.depth_max = (uint16_t)depth;
+}
+
+const render_frame_t *render_queue_peek(render_queue_t *q) {
+    if (q->head == q->tail) return NULL;
+    __dmb(); /* tail before the frame contents */
+    return &q->slots[q->head % RENDER_QUEUE_DEPTH];
+}
+
+void render_queue_release(render_queue_t *q) {
+    __dmb(); /* done reading before the slot is handed back */
+    q->head++;
+    q->stats.rendered++;
+}
+
+int render_queue_depth(const render_queue_t *q) {
+    return (int)(q->tail - q->head);
+}
+
+void render_queue_get_stats(const render_queue_t *q, render_queue_stats_t *stats) {
+    *stats = q->stats;
+}
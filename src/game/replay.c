@@ -0,0 +1,152 @@
+#include "game/replay.h"
+#include "game/game.h"
+
+#define END_MARKER (-128)
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/* =======================
+   Recording
+   ======================= */
+static uint8_t *rec_buf;
+static size_t rec_capacity;
+static size_t rec_length;
+static bool rec_active;
+static bool rec_overflow;
+static uint32_t rec_ticks;
+static int8_t run_move;
+static bool run_fire;
+static int run_length; /* 0 = no pending run */
+
+static void flush_run(void) {
+    if (run_length == 0) return;
+    if (rec_length + 2 > rec_capacity - REPLAY_FOOTER_SIZE) {
+        rec_overflow = true;
+        return;
+    }
+    rec_buf[rec_length++] = (uint8_t)run_move;
+    rec_buf[rec_length++] = (uint8_t)((run_fire ? 0x80 : 0) | (run_length - 1));
+    run_length = 0;
+}
+
+void replay_record_start(uint8_t *buf, size_t capacity, uint32_t seed) {
+    rec_buf = buf;
+    rec_capacity = capacity;
+    rec_overflow = capacity < REPLAY_HEADER_SIZE + REPLAY_FOOTER_SIZE;
+    rec_active = !rec_overflow;
+    rec_ticks = 0;
+    run_length = 0;
+    if (!rec_active) return;
+
+    buf[0] = 'S';
+    buf[1] = 'I';
+    buf[2] = 'R';
+    buf[3] = '1';
+    put_u16(buf + 4, GAME_TICK_HZ);
+    put_u16(buf + 6, 0);
+    put_u32(buf + 8, seed);
+    rec_length = REPLAY_HEADER_SIZE;
+}
+
+bool replay_record_tick(int8_t move, bool fire) {
+    if (!rec_active || rec_overflow) return false;
+    if (run_length > 0 && (move != run_move || fire != run_fire || run_length == 128))
+        flush_run();
+    if (rec_overflow) return false;
+    if (run_length == 0) {
+        run_move = move;
+        run_fire = fire;
+    }
+    run_length++;
+    rec_ticks++;
+    return true;
+}
+
+size_t replay_record_finish(uint32_t state_hash) {
+    if (!rec_active) return 0;
+    rec_active = false;
+    flush_run();
+    if (rec_overflow) return 0;
+
+    uint8_t *p = rec_buf + rec_length;
+    p[0] = (uint8_t)END_MARKER;
+    p[1] = 0;
+    put_u32(p + 2, rec_ticks);
+    put_u32(p + 6, state_hash);
+    rec_length += REPLAY_FOOTER_SIZE;
+    return rec_length;
+}
+
+bool replay_recording(void) {
+    return rec_active;
+}
+
+/* =======================
+   Playback
+   ======================= */
+static const uint8_t *play_data;
+static size_t play_length;
+static size_t play_pos;
+static bool play_active;
+static int play_left; /* ticks left in the current run */
+static int8_t play_move;
+static bool play_fire;
+
+bool replay_play_start(const uint8_t *data, size_t length, uint32_t *seed) {
+    play_active = false;
+    if (length < REPLAY_HEADER_SIZE + REPLAY_FOOTER_SIZE) return false;
+    if (data[0] != 'S' || data[1] != 'I' || data[2] != 'R' || data[3] != '1') return false;
+    if ((data[4] | data[5] << 8) != GAME_TICK_HZ) return false; /* other tick rate */
+
+    play_data = data;
+    play_length = length;
+    play_pos = REPLAY_HEADER_SIZE;
+    play_left = 0;
+    play_active = true;
+    *seed = get_u32(data + 8);
+    return true;
+}
+
+bool replay_play_tick(int8_t *move, bool *fire) {
+    if (!play_active) return false;
+    if (play_left == 0) {
+        if (play_pos + 2 > play_length || (int8_t)play_data[play_pos] == END_MARKER) {
+            play_active = false;
+            return false;
+        }
+        play_move = (int8_t)play_data[play_pos];
+        play_fire = play_data[play_pos + 1] & 0x80;
+        play_left = (play_data[play_pos + 1] & 0x7F) + 1;
+        play_pos += 2;
+    }
+    play_left--;
+    *move = play_move;
+    *fire = play_fire;
+    return true;
+}
+
+bool replay_playing(void) {
+    return play_active;
+}
+
+bool replay_expected(uint32_t *ticks, uint32_t *state_hash) {
+    /* The footer ends the stream */
+    if (play_data == NULL || play_length < REPLAY_HEADER_SIZE + REPLAY_FOOTER_SIZE) return false;
+    const uint8_t *p = play_data + play_length - REPLAY_FOOTER_SIZE;
+    if ((int8_t)p[0] != END_MARKER) return false;
+    *ticks = get_u32(p + 2);
+    *state_hash = get_u32(p + 6);
+    return true;
+}
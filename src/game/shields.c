@@ -0,0 +1,116 @@
+#include "game/shields.h"
+#include "game/game.h"
+
+#define SHIELD_COLOR 0x07E0 /* green */
+#define SHIELD_SPACING ((128 - SHIELD_COUNT * SHIELD_W) / SHIELD_COUNT)
+
+/* The arcade bunker: rounded top, notch at the bottom */
+static const uint32_t shield_shape[SHIELD_H] = {
+    0x0FFFC000, /* ....XXXXXXXXXXXXXX.... */
+    0x1FFFE000, /* ...XXXXXXXXXXXXXXXX... */
+    0x3FFFF000, /* ..XXXXXXXXXXXXXXXXXX.. */
+    0x7FFFF800, /* .XXXXXXXXXXXXXXXXXXXX. */
+    0xFFFFFC00, /* XXXXXXXXXXXXXXXXXXXXXX */
+    0xFFFFFC00,
+    0xFFFFFC00,
+    0xFFFFFC00,
+    0xFE01FC00, /* XXXXXXX........XXXXXXX */
+    0xFC00FC00, /* XXXXXX..........XXXXXX */
+    0xF8007C00, /* XXXXX............XXXXX */
+    0xF8007C00,
+};
+
+/* Crater cleared around an impact, centre at column 3 of row 2 */
+#define CRATER_H  5
+#define CRATER_CX 3
+#define CRATER_CY 2
+static const uint32_t crater[CRATER_H] = {
+    0x54000000, /* .X.X.X. */
+    0x7C000000, /* .XXXXX. */
+    0xFE000000, /* XXXXXXX */
+    0x7C000000, /* .XXXXX. */
+    0xA8000000, /* X.X.X.. */
+};
+
+static uint32_t rows[SHIELD_COUNT][SHIELD_H];
+
+static inline int shield_x(int s) {
+    return SHIELD_SPACING / 2 + s * (SHIELD_W + SHIELD_SPACING);
+}
+
+/* Mask of a left-aligned bit pattern moved dx columns right (left when
+   negative), bits pushed past either end dropped */
+static inline uint32_t shift_mask(uint32_t pattern, int dx) {
+    if (dx >= 32 || dx <= -32) return 0;
+    return dx >= 0 ? pattern >> dx : pattern << -dx;
+}
+
+void shields_init(void) {
+    for (int s = 0; s < SHIELD_COUNT; s++)
+        for (int r = 0; r < SHIELD_H; r++)
+            rows[s][r] = shield_shape[r];
+}
+
+void shields_get_bounds(int *x, int *y, int *w, int *h) {
+    *x = shield_x(0);
+    *y = SHIELD_Y;
+    *w = shield_x(SHIELD_COUNT - 1) + SHIELD_W - *x;
+    *h = SHIELD_H;
+}
+
+static void erode(uint32_t *bitmap, int row, int col) {
+    for (int i = 0; i < CRATER_H; i++) {
+        int r = row + i - CRATER_CY;
+        if (r >= 0 && r < SHIELD_H)
+            bitmap[r] &= ~shift_mask(crater[i], col - CRATER_CX);
+    }
+}
+
+bool shields_hit(int x, int y, int w, int h, int dir) {
+    if (y + h <= SHIELD_Y || y >= SHIELD_Y + SHIELD_H) return false;
+
+    for (int s = 0; s < SHIELD_COUNT; s++) {
+        int dx = x - shield_x(s);
+        if (dx >= SHIELD_W || dx + w <= 0) continue;
+
+        /* The shot's columns as one word, then one AND per row it covers */
+        uint32_t span = shift_mask(~0u << (32 - w), dx);
+        int r0 = y - SHIELD_Y < 0 ? 0 : y - SHIELD_Y;
+        int r1 = y + h - SHIELD_Y > SHIELD_H ? SHIELD_H : y + h - SHIELD_Y;
+        uint32_t *bitmap = rows[s];
+        for (int i = 0; i < r1 - r0; i++) {
+            int r = dir < 0 ? r1 - 1 - i : r0 + i;
+            uint32_t contact = bitmap[r] & span;
+            if (contact) {
+                erode(bitmap, r, __builtin_clz(contact));
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void shields_draw(render_frame_t *frame) {
+    uint8_t bits[SHIELD_TILE_H];
+    for (int s = 0; s < SHIELD_COUNT; s++) {
+        for (int ty = 0; ty < SHIELD_TILES_Y; ty++) {
+            int r0 = ty * SHIELD_TILE_H;
+            int th = SHIELD_H - r0 < SHIELD_TILE_H ? SHIELD_H - r0 : SHIELD_TILE_H;
+            for (int tx = 0; tx < SHIELD_TILES_X; tx++) {
+                int c0 = tx * SHIELD_TILE_W;
+                int tw = SHIELD_W - c0 < SHIELD_TILE_W ? SHIELD_W - c0 : SHIELD_TILE_W;
+                uint8_t any = 0;
+                for (int r = 0; r < th; r++) {
+                    bits[r] = (uint8_t)(rows[s][r0 + r] << c0 >> 24);
+                    any |= bits[r];
+                }
+                if (any)
+                    render_frame_add_tile(frame, shield_x(s) + c0, SHIELD_Y + r0, tw, th, SHIELD_COLOR, bits);
+            }
+        }
+    }
+}
+
+uint32_t shields_state_hash(uint32_t h) {
+    return game_hash(h, rows, sizeof(rows));
+}
@@ -0,0 +1,284 @@
+#include "game/sounds.h"
+
+#define PCM_RATE 8000
+
+/* =======================
+   Samples (signed 8-bit, 8 kHz)
+   =======================
+   Synthesized: the shot is a square wave sweeping from 1400 Hz down to
+   250 Hz, the explosion low-passed noise with an exponential decay, the
+   march a 140 Hz triangle thump. */
+static const int8_t shot_pcm[800] = {
+    100, 100, -100, -99, -99, 99, 99, 99, -99, -98, -98, 98, 98, 98, -97, -97,
+    -97, 97, 97, 96, -96, -96, -96, 96, 96, 95, -95, -95, 95, 95, 94, -94,
+    -94, -94, 94, 94, 93, -93, -93, -93, 93, 92, 92, -92, -92, -92, 92, 91,
+    91, -91, -91, -91, 90, 90, 90, -90, -90, -90, 89, 89, 89, -89, -89, -88,
+    88, 88, 88, 88, -88, -87, -87, 87, 87, 87, -86, -86, -86, 86, 86, 86,
+    -85, -85, -85, 85, 85, 84, -84, -84, -84, 84, 84, 83, -83, -83, -83, -83,
+    83, 82, 82, -82, -82, -82, 81, 81, 81, -81, -81, -81, 80, 80, 80, 80,
+    -80, -80, -79, 79, 79, 79, -79, -79, -78, 78, 78, 78, 78, -78, -77, -77,
+    77, 77, 77, -76, -76, -76, -76, 76, 76, 75, -75, -75, -75, 75, 75, 74,
+    74, -74, -74, -74, 74, 73, 73, -73, -73, -73, -73, 72, 72, 72, -72, -72,
+    -72, 71, 71, 71, 71, -71, -71, -70, 70, 70, 70, 70, -70, -69, -69, 69,
+    69, 69, 69, -68, -68, -68, 68, 68, 68, 67, -67, -67, -67, 67, 67, 66,
+    66, -66, -66, -66, 66, 65, 65, 65, -65, -65, -65, -64, 64, 64, 64, -64,
+    -64, -63, -63, 63, 63, 63, 63, -63, -62, -62, 62, 62, 62, 62, -61, -61,
+    -61, -61, 61, 61, 60, -60, -60, -60, -60, 60, 60, 59, 59, -59, -59, -59,
+    -59, 58, 58, 58, -58, -58, -58, -57, 57, 57, 57, 57, -57, -57, -56, -56,
+    56, 56, 56, 56, -55, -55, -55, -55, 55, 55, 55, 54, -54, -54, -54, -54,
+    54, 53, 53, 53, -53, -53, -53, -53, 52, 52, 52, 52, -52, -52, -52, -51,
+    51, 51, 51, 51, -51, -50, -50, -50, 50, 50, 50, 50, -49, -49, -49, -49,
+    49, 49, 49, 48, -48, -48, -48, -48, 48, 47, 47, 47, 47, -47, -47, -47,
+    -46, 46, 46, 46, 46, -46, -46, -45, -45, -45, 45, 45, 45, 45, -44, -44,
+    -44, -44, 44, 44, 44, 43, 43, -43, -43, -43, -43, 43, 42, 42, 42, 42,
+    -42, -42, -42, -41, 41, 41, 41, 41, 41, -41, -41, -40, -40, 40, 40, 40,
+    40, 40, -39, -39, -39, -39, 39, 39, 39, 38, 38, -38, -38, -38, -38, -38,
+    37, 37, 37, 37, -37, -37, -37, -37, -36, 36, 36, 36, 36, 36, -36, -35,
+    -35, -35, -35, 35, 35, 35, 35, 34, -34, -34, -34, -34, -34, 34, 34, 33,
+    33, 33, -33, -33, -33, -33, -32, 32, 32, 32, 32, 32, -32, -32, -31, -31,
+    -31, 31, 31, 31, 31, 31, -30, -30, -30, -30, -30, 30, 30, 30, 29, 29,
+    -29, -29, -29, -29, -29, -29, 28, 28, 28, 28, 28, -28, -28, -28, -27, -27,
+    -27, 27, 27, 27, 27, 27, -26, -26, -26, -26, -26, -26, 26, 26, 26, 25,
+    25, -25, -25, -25, -25, -25, -25, 24, 24, 24, 24, 24, 24, -24, -24, -24,
+    -23, -23, -23, 23, 23, 23, 23, 23, -23, -22, -22, -22, -22, -22, 22, 22,
+    22, 21, 21, 21, -21, -21, -21, -21, -21, -21, -20, 20, 20, 20, 20, 20,
+    20, -20, -20, -19, -19, -19, -19, 19, 19, 19, 19, 19, 19, -18, -18, -18,
+    -18, -18, -18, -18, 18, 18, 17, 17, 17, 17, -17, -17, -17, -17, -17, -17,
+    -16, 16, 16, 16, 16, 16, 16, 16, -16, -16, -15, -15, -15, -15, -15, 15,
+    15, 15, 15, 15, 14, 14, -14, -14, -14, -14, -14, -14, -14, 14, 13, 13,
+    13, 13, 13, 13, -13, -13, -13, -13, -12, -12, -12, -12, 12, 12, 12, 12,
+    12, 12, 12, -11, -11, -11, -11, -11, -11, -11, -11, 11, 11, 11, 10, 10,
+    10, 10, 10, -10, -10, -10, -10, -10, -10, -10, -9, 9, 9, 9, 9, 9,
+    9, 9, 9, 9, -9, -9, -8, -8, -8, -8, -8, -8, 8, 8, 8, 8,
+    8, 8, 7, 7, 7, -7, -7, -7, -7, -7, -7, -7, -7, -7, 7, 6,
+    6, 6, 6, 6, 6, 6, 6, -6, -6, -6, -6, -6, -6, -5, -5, -5,
+    -5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, -4, -4, -4, -4, -4,
+    -4, -4, -4, -4, -4, 4, 4, 4, 4, 4, 4, 3, 3, 3, 3, 3,
+    -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, -3, 3, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, -2, -2, -2, -2, -2, -2, -2, -2, -2,
+    -1, -1, -1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const int8_t explosion_pcm[2000] = {
+    0, -3, 0, -9, -3, -6, -21, -8, -29, -16, -36, -45, -24, 20, -29, -39,
+    -1, 52, 29, -3, 64, -41, 38, -19, -65, -88, -66, 33, -48, -2, 27, -16,
+    4, -94, -127, -117, 0, -18, -53, 2, -11, -56, 56, 72, -40, 5, 8, 99,
+    94, -20, 115, -55, -41, 50, -69, -28, -125, -4, 65, 42, 108, -7, 46, 40,
+    34, 2, 84, 127, 45, 56, -86, 17, 42, 127, 126, -5, -29, 29, -102, -47,
+    -96, -126, -127, 7, -84, -90, -59, 64, -73, -39, -3, 87, 106, 123, -5, -21,
+    -40, 72, 127, -30, -84, -92, -94, -39, 5, -51, -127, -66, -54, -6, 97, 79,
+    33, 38, 53, -77, 57, 82, 112, 106, 17, -15, -90, -6, -95, -127, -110, -113,
+    -77, -123, -127, -127, -127, -79, -127, 28, 34, -59, -74, -60, -51, -96, 34, 113,
+    37, 11, -79, -111, -74, -76, 36, -53, -115, 45, 23, -61, -15, -99, -33, 81,
+    102, 78, -16, -32, -77, 22, 15, 59, -9, -56, 37, 107, 109, 100, 99, 84,
+    -18, -4, -28, -99, -127, -91, -80, 4, 85, 24, 90, 125, 127, 28, -40, -65,
+    -81, -85, -12, 67, 88, 31, 40, 69, -46, 10, 76, 80, 76, 27, -45, 32,
+    -16, 46, 100, 22, -8, 73, 68, -29, -75, -90, 32, 65, -33, 41, 97, 66,
+    2, 9, -58, -104, 36, 39, 20, 79, 22, 70, 81, -14, -46, -52, -63, -12,
+    -44, -31, -72, 36, -8, -10, 9, 68, 15, 72, 30, 17, 11, -70, -38, -65,
+    -103, 3, -49, -24, 24, 19, -19, -5, 6, 46, -40, -8, -41, -50, 20, 9,
+    13, 44, 79, 25, 27, 12, 7, 31, 6, 7, 0, 64, 56, 78, 96, 6,
+    11, 68, 77, -19, -62, -34, -75, -68, -89, -14, 34, 70, -18, 22, 32, -36,
+    37, 80, -4, 60, 12, 3, 68, 74, -14, -15, -4, -23, -51, -46, 10, -59,
+    -18, -16, -70, -52, -6, -1, -57, 38, 54, 84, -15, -36, -75, 3, -28, -59,
+    -36, 37, 56, -6, -47, 32, 23, 35, -36, -71, -7, -12, -58, 29, 29, 50,
+    -29, 31, -39, 27, 6, -17, -1, 51, -5, -47, -17, -39, -63, -68, -83, -72,
+    -54, -47, 10, -20, -9, -41, -36, -72, -61, -83, -10, 1, -35, -18, 41, -26,
+    24, 3, 1, 38, 5, 3, 22, 64, 11, 42, 41, 34, 5, -15, -55, -65,
+    -76, -8, -30, -50, -67, 6, 43, 37, -6, -30, -36, -20, -45, -26, -37, 32,
+    64, 34, -11, 43, 0, -15, -58, -39, -20, -9, -35, -15, -57, -50, -64, -39,
+    -64, -77, -55, -52, -15, -4, 23, 26, 33, 53, 13, -11, 42, -15, 15, 21,
+    -34, 16, 45, 33, 38, 47, -12, -4, -1, 31, 43, 51, 31, 51, 41, 37,
+    -8, -47, -56, -39, -54, 5, 8, 15, 19, 25, 11, -40, 8, 26, 13, 9,
+    18, -30, 7, -19, -46, -43, 0, -26, 9, 46, 21, 0, -2, 15, 30, 24,
+    24, -25, -42, -41, 1, -16, -2, -42, -57, -46, -8, 12, 21, -8, -2, -4,
+    -5, -34, 16, -17, 31, 50, -15, -11, 21, 48, 19, -10, -28, 22, -12, 1,
+    -28, -12, 30, -14, 18, 9, 35, 33, -5, 28, 13, -31, -53, -26, -17, -23,
+    -39, -31, -29, 12, -32, 3, 27, -15, 24, 28, 43, 6, -7, -11, 31, 22,
+    0, -5, -19, -42, -49, 0, -15, 24, -6, -20, -9, -27, -22, 21, 38, 41,
+    29, 43, 52, 29, 30, -17, 8, 1, 18, 19, -5, -34, 12, -19, -11, -16,
+    -22, 5, 35, 1, 11, -8, 0, -7, -26, -35, -37, 8, 4, -16, 18, 42,
+    18, -15, -27, -40, -30, -41, -38, -34, -13, 18, 25, 7, -2, 1, -7, -14,
+    -34, -31, 13, -16, -8, 4, 24, -5, -17, -24, -18, -13, 21, 32, 39, -9,
+    -33, -4, 22, 9, 10, -25, -19, 15, 27, 35, 45, 9, -18, -29, -14, 3,
+    27, 27, 22, 27, 11, 9, -22, 5, -13, 17, 17, -2, -22, -25, -5, 8,
+    -17, -33, -16, -3, -8, -19, -4, -29, -26, -16, 17, 16, 29, 14, -7, -17,
+    16, 19, 0, -25, -13, 2, -3, -14, 1, 23, -2, -25, -22, -15, 1, -15,
+    7, 16, 9, -10, 18, 0, 16, -5, -17, 4, -8, 18, 9, -10, -19, -14,
+    1, 22, -5, -8, -18, 13, -10, -27, -35, -24, 6, 22, 23, 36, 39, 13,
+    -8, 16, 20, -11, 2, -5, -8, -12, -22, -35, -29, -22, 9, -12, 14, -5,
+    -9, 9, 20, 7, -16, -10, -11, 13, -7, -10, 12, -14, -11, 7, 16, -12,
+    -26, -33, 0, -10, 5, 20, 4, -8, 15, 13, -3, 8, -4, -11, -27, -4,
+    15, 14, 26, -6, -14, -9, 14, 26, 10, -5, -5, -3, 15, -4, 10, 15,
+    21, 22, 17, 2, -6, -9, 6, -13, -19, -1, -10, -23, -31, -15, -15, 10,
+    20, 30, 8, -12, -22, -12, 1, -1, -11, -9, -1, 6, 13, 20, 17, -4,
+    10, -2, 1, -4, 7, -7, -13, -17, -22, 2, 4, -4, -6, 14, 8, -5,
+    8, 10, 23, -1, -2, 10, 18, 24, -2, -8, -18, -21, 5, 5, 18, 6,
+    16, 7, -4, 7, 19, -2, 2, 5, -7, -8, -16, -19, -19, -7, 1, -9,
+    -21, -18, -4, -13, -13, -17, 0, 1, -13, -20, -15, -7, 0, -13, -18, -4,
+    -5, -10, -12, 7, -2, 1, -4, -5, 8, 20, 7, -5, 4, -7, -19, 1,
+    -2, 9, 2, 13, 6, -6, -18, -9, -1, 11, -5, 0, -4, -2, -11, -13,
+    -7, 8, -6, -4, 6, 17, 1, -10, 7, 17, 10, -7, 8, 1, 12, 10,
+    15, -1, 8, -3, -4, 7, 13, -1, -8, -8, -4, -5, -13, -15, -3, 9,
+    -7, -2, 5, -9, 4, -8, -2, 0, 3, -3, -4, 0, -2, 3, 0, -1,
+    -13, -5, -3, -8, 2, 8, 4, -6, -4, -12, -16, -11, -17, -11, -7, -15,
+    -6, -14, -2, 5, 3, -9, -5, -6, 7, -4, 6, 15, 15, 16, 3, 13,
+    7, 15, 19, 4, 9, 15, -1, -4, 3, -6, 6, -2, 6, -4, -3, 8,
+    -2, -6, -4, -6, -14, -16, -17, -1, 4, 11, -1, 6, -5, -2, 2, -2,
+    7, 5, 5, 11, -2, 9, 9, 3, 8, 0, 10, 8, 2, 7, 3, -5,
+    2, -8, 2, -4, 0, 10, 8, 8, 1, -9, -15, -16, -8, -6, -3, 6,
+    -4, -8, -2, -10, -16, -13, -16, -12, -13, -6, -2, -7, -2, -2, -8, 3,
+    -3, -8, -13, -5, 4, 8, 3, -3, -11, -4, -1, -4, 0, -1, 7, 9,
+    1, 8, -3, -1, -3, -6, -12, -2, -10, -5, 4, -4, -8, -3, -2, 1,
+    6, -2, -4, -6, -12, -1, 4, 6, -4, 3, 6, 3, 6, 3, -3, -8,
+    -10, -14, -11, -3, 1, 6, 8, 1, 1, 0, 5, 3, -2, 1, 8, 1,
+    6, -4, -6, -8, -1, 6, 8, 2, 7, 2, -3, 5, 5, 6, 6, 11,
+    7, 10, 9, 11, 6, 7, 6, 1, -4, -1, -7, 2, -4, -10, -12, -1,
+    -3, -7, -12, -14, -6, -2, 1, 4, -3, -1, -3, 3, 6, 10, 0, 5,
+    9, 12, 2, -2, -7, -11, -2, 3, 4, 7, 6, 1, -5, -8, -2, -5,
+    -6, -5, -10, -9, -9, -3, -4, -5, 3, 2, 6, 5, -3, -3, -3, 2,
+    -1, 2, 2, -2, 3, -3, 2, -3, -8, -9, -3, 4, -3, -2, -2, 3,
+    -2, -2, -3, 2, -1, 4, 0, -3, 0, 0, -5, -1, -6, -1, 2, 5,
+    5, 1, 0, -1, 4, -2, 3, -4, -6, -7, 0, 0, -1, 4, -1, -1,
+    0, 3, 5, 5, 1, -1, -4, 1, 2, 4, -1, -1, 2, 2, -2, -2,
+    3, -1, -4, -5, -1, 3, -2, -5, -6, -6, -4, -6, -6, -7, 0, 2,
+    -2, 3, -2, -3, 3, 5, 6, 3, -1, 1, -3, -5, -5, -8, -6, -1,
+    1, 1, 2, 1, -3, -1, -2, 1, 5, 3, 2, 4, 2, -1, 1, 4,
+    6, 6, 7, 7, 6, 4, 1, 2, -3, -2, 1, 3, 3, 0, -1, -1,
+    0, -1, 1, 5, 0, 2, 4, 1, 1, 5, -1, 0, -3, 0, 4, 3,
+    -1, 0, 0, 2, 1, 2, 4, 3, 1, 5, 1, 2, 1, 3, -1, 3,
+    1, -3, -4, -4, -6, -5, -4, -1, -2, -3, -5, -1, 3, 2, -1, 2,
+    0, -2, -4, -1, 2, 2, 1, 1, -1, 3, 1, 2, 4, 5, 3, 1,
+    1, -2, 1, 0, 2, 0, -1, -3, -2, -4, -6, -3, -4, -4, -5, -3,
+    -3, -1, 0, -1, 3, 4, 0, 2, 4, 5, 1, 3, 3, -1, -4, 0,
+    1, -1, -3, -5, -5, -2, -2, -4, 0, 2, -1, 2, 2, 3, 4, 5,
+    6, 6, 2, 3, 2, 3, 2, 4, 3, 1, -1, -3, -2, -4, -3, -5,
+    -3, -2, -2, 1, -2, 0, 0, 0, 1, 3, 1, 1, 3, 0, 1, 1,
+    -2, -1, 1, 3, 1, 4, 3, 2, 4, 0, 1, 2, 0, 2, 1, 0,
+    1, 2, 0, -1, -1, 0, 2, 0, 2, 1, 1, -1, -1, 2, 2, 3,
+    2, 0, -1, 0, 1, 2, -1, 0, 2, 2, -1, -2, -4, -4, -1, 0,
+    1, 2, 4, 3, 3, 3, 3, 3, 3, 1, 1, 1, 2, -1, -2, -4,
+    -1, 1, 1, 0, 2, 3, 2, 1, -1, -1, -1, -1, 0, 2, -1, 0,
+    -2, -4, -1, -1, 2, 1, -2, -2, -1, 1, 3, 2, 1, -1, 0, -1,
+    -3, -4, -5, -3, -4, -1, -3, 0, -2, -3, -2, -2, -1, -2, -3, -1,
+    0, 1, 2, 0, 0, 1, 1, 2, 1, 2, 3, 0, -2, -1, 1, -1,
+    -2, 0, -2, 0, 0, -2, -2, -1, -1, 0, -1, 0, 0, 0, 1, 0,
+    0, 1, 2, 3, 2, 1, -1, 1, 2, 2, 1, 1, 3, 3, 3, 2,
+    1, 2, 1, 2, 2, 3, 3, 2, -1, -1, -1, -1, 1, 2, 0, 1,
+    2, 3, 2, 1, 2, 3, 3, 3, 2, 0, 0, 1, 0, 1, 2, 1,
+    1, 1, 1, 0, -1, 0, 1, 1, -1, 0, 1, 0, 0, 1, 2, 2,
+    1, 1, 0, -1, -2, -1, -1, -1, -1, -1, -1, -3, 0, -1, -2, -1,
+    0, -1, 0, -1, -1, -2, -3, -1, 0, 0, 0, 0, 1, 0, 1, 2,
+    2, 3, 2, 0, -1, -1, -2, -3, -2, -1, -1, 1, 2, 0, 0, 0,
+    -1, 0, 0, 0, 0, 1, 2, 1, 1, 0, 1, 2, 1, -1, -1, -1,
+    0, 1, 2, 0, 1, 1, 1, 2, 1, 0, 0, 1, 2, 1, 1, 1,
+    0, 0, -1, -2, -1, -2, -2, -3, -2, -2, -1, -2, -3, -1, -2, 0,
+    1, 1, 0, 0, -1, 0, 1, 1, 1, 0, 1, 1, 1, 0, -1, -2,
+    -1, -1, -1, 0, -1, -1, -1, -2, -1, -1, -1, -1, -1, 0, -1, 0,
+    -1, 0, 1, 0, 0, -1, -1, -1, -1, 0, 1, 2, 0, 0, 1, 0,
+    0, 0, 1, 0, 0, 0, -1, -2, -1, 0, -1, -1, 0, -1, 0, -1,
+    -1, -1, 0, -1, -1, -2, -1, -1, -1, -2, -1, -1, 0, 0, 0, -1,
+    0, -1, 0, -1, 0, 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0,
+    0, 0, -1, 0, -1, -1, -1, -1, -1, -1, 0, 1, 0, 1, 0, 1,
+    0, 0, 1, 1, 1, 1, 1, 0, 1, 0, 0, -1, -1, -1, -1, -2,
+    -1, -1, -2, -1, -1, -1, 0, -1, 0, 0, -1, -1, -1, -1, -1, -1,
+    -1, -2, -1, 0, -1, -1, 0, -1, 0, 1, 0, 0, 1, 1, 0, 1,
+    1, 1, 0, 0, 0, 1, 1, 1, 1, 2, 1, 1, 1, 2, 1, 1,
+    1, 1, 0, 0, 0, 0, -1, -1, 0, 0, 1, 1, 1, 1, 2, 1,
+};
+
+static const int8_t march_pcm[720] = {
+    0, 6, 11, 15, 18, 21, 22, 22, 21, 19, 16, 12, 8, 2, -5, -12,
+    -21, -29, -36, -44, -51, -59, -66, -73, -81, -88, -95, -102, -103, -95, -88, -80,
+    -72, -65, -57, -50, -43, -35, -28, -21, -13, -6, 1, 8, 15, 22, 29, 36,
+    43, 50, 57, 64, 70, 77, 84, 90, 97, 92, 85, 78, 71, 64, 57, 50,
+    43, 36, 29, 23, 16, 9, 3, -4, -10, -17, -23, -30, -36, -42, -48, -55,
+    -61, -67, -73, -79, -85, -88, -81, -75, -68, -62, -55, -49, -43, -37, -30, -24,
+    -18, -12, -6, 0, 6, 12, 18, 24, 29, 35, 41, 47, 52, 58, 64, 69,
+    75, 80, 77, 71, 66, 60, 54, 48, 42, 37, 31, 25, 20, 14, 9, 3,
+    -2, -8, -13, -18, -24, -29, -34, -39, -45, -50, -55, -60, -65, -70, -73, -68,
+    -63, -57, -52, -47, -41, -36, -31, -26, -21, -16, -11, -6, -1, 4, 9, 14,
+    19, 24, 28, 33, 38, 42, 47, 52, 56, 61, 65, 64, 59, 54, 50, 45,
+    40, 35, 31, 26, 21, 17, 12, 8, 3, -1, -6, -10, -14, -19, -23, -27,
+    -32, -36, -40, -44, -48, -52, -56, -60, -56, -51, -47, -43, -38, -34, -30, -26,
+    -22, -17, -13, -9, -5, -1, 3, 7, 11, 15, 18, 22, 26, 30, 34, 37,
+    41, 45, 48, 52, 52, 48, 44, 40, 36, 33, 29, 25, 21, 18, 14, 10,
+    7, 3, -1, -4, -8, -11, -14, -18, -21, -25, -28, -31, -34, -38, -41, -44,
+    -47, -45, -41, -38, -34, -31, -27, -24, -21, -17, -14, -11, -8, -5, -1, 2,
+    5, 8, 11, 14, 17, 20, 23, 26, 29, 32, 34, 37, 40, 41, 38, 35,
+    32, 29, 26, 23, 20, 17, 14, 11, 8, 6, 3, 0, -3, -5, -8, -11,
+    -13, -16, -19, -21, -24, -26, -29, -31, -34, -36, -35, -32, -29, -27, -24, -21,
+    -19, -16, -14, -11, -9, -6, -4, -1, 1, 3, 6, 8, 10, 13, 15, 17,
+    19, 21, 24, 26, 28, 30, 31, 29, 27, 24, 22, 20, 17, 15, 13, 11,
+    9, 7, 4, 2, 0, -2, -4, -6, -8, -10, -12, -14, -15, -17, -19, -21,
+    -23, -25, -26, -26, -24, -22, -20, -18, -16, -14, -12, -10, -8, -7, -5, -3,
+    -1, 0, 2, 4, 6, 7, 9, 11, 12, 14, 15, 17, 18, 20, 21, 23,
+    21, 19, 18, 16, 14, 13, 11, 10, 8, 6, 5, 3, 2, 0, -1, -2,
+    -4, -5, -7, -8, -9, -11, -12, -13, -15, -16, -17, -18, -18, -17, -15, -14,
+    -13, -11, -10, -9, -7, -6, -5, -4, -2, -1, 0, 1, 3, 4, 5, 6,
+    7, 8, 9, 10, 11, 12, 13, 14, 15, 14, 13, 12, 11, 10, 9, 8,
+    7, 5, 4, 3, 2, 1, 0, -1, -2, -2, -3, -4, -5, -6, -7, -8,
+    -9, -9, -10, -11, -12, -12, -11, -10, -9, -8, -7, -7, -6, -5, -4, -3,
+    -2, -2, -1, 0, 1, 1, 2, 3, 4, 4, 5, 6, 6, 7, 8, 8,
+    9, 9, 9, 8, 7, 7, 6, 5, 5, 4, 3, 3, 2, 2, 1, 0,
+    0, -1, -1, -2, -2, -3, -3, -4, -4, -5, -5, -6, -6, -7, -7, -6,
+    -6, -5, -5, -4, -4, -3, -3, -2, -2, -1, -1, 0, 0, 0, 1, 1,
+    2, 2, 2, 3, 3, 3, 4, 4, 4, 5, 5, 5, 4, 4, 4, 3,
+    3, 2, 2, 2, 1, 1, 1, 0, 0, 0, 0, -1, -1, -1, -1, -2,
+    -2, -2, -2, -2, -3, -3, -3, -3, -3, -3, -2, -2, -2, -2, -1, -1,
+    -1, -1, -1, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+const audio_sample_t sound_shot = { shot_pcm, sizeof(shot_pcm), PCM_RATE };
+const audio_sample_t sound_explosion = { explosion_pcm, sizeof(explosion_pcm), PCM_RATE };
+const audio_sample_t sound_march = { march_pcm, sizeof(march_pcm), PCM_RATE };
+
+/* =======================
+   Cues
+   ======================= */
+
+/* Descending by two, two and one semitones, as in the arcade */
+static const uint32_t march_pitch[4] = {
+    AUDIO_PITCH_ONE,
+    58386, /* 2^(-2/12) */
+    52016, /* 2^(-4/12) */
+    49097, /* 2^(-5/12) */
+};
+static int march_note;
+
+void sounds_shot(void) {
+    audio_play(AUDIO_CH_SHOT, &sound_shot, AUDIO_PITCH_ONE, 140);
+}
+
+void sounds_invader_killed(void) {
+    audio_play(AUDIO_CH_EXPLOSION, &sound_explosion, AUDIO_PITCH_ONE, 200);
+}
+
+/* The explosion an octave down, on its own channel */
+void sounds_player_hit(void) {
+    audio_play(AUDIO_CH_EVENT, &sound_explosion, AUDIO_PITCH_ONE / 2, 255);
+}
+
+/* The march thump an octave up, over the pause before the next wave. On
+   the march channel: the formation is gone, and on top of the last
+   explosion a third channel would clip. */
+void sounds_wave_cleared(void) {
+    audio_play(AUDIO_CH_MARCH, &sound_march, AUDIO_PITCH_ONE * 2, 200);
+}
+
+void sounds_march_step(void) {
+    audio_play(AUDIO_CH_MARCH, &sound_march, march_pitch[march_note], 230);
+    march_note = (march_note + 1) & 3;
+}
+
+void sounds_reset(void) {
+    march_note = 0;
+}
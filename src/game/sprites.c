@@ -0,0 +1,96 @@
+#include "game/sprites.h"
+
+/* =======================
+   Invaders (1bpp, 10x8, 2 frames)
+   ======================= */
+static const uint8_t squid_data[] = {
+    /* frame 0 */
+    0x0C, 0x00, /* ....XX.... */
+    0x1E, 0x00, /* ...XXXX... */
+    0x3F, 0x00, /* ..XXXXXX.. */
+    0x6D, 0x80, /* .XX.XX.XX. */
+    0x7F, 0x80, /* .XXXXXXXX. */
+    0x12, 0x00, /* ...X..X... */
+    0x2D, 0x00, /* ..X.XX.X.. */
+    0x52, 0x80, /* .X.X..X.X. */
+    /* frame 1 */
+    0x0C, 0x00, /* ....XX.... */
+    0x1E, 0x00, /* ...XXXX... */
+    0x3F, 0x00, /* ..XXXXXX.. */
+    0x6D, 0x80, /* .XX.XX.XX. */
+    0x7F, 0x80, /* .XXXXXXXX. */
+    0x2D, 0x00, /* ..X.XX.X.. */
+    0x40, 0x80, /* .X......X. */
+    0x21, 0x00, /* ..X....X.. */
+};
+
+static const uint8_t crab_data[] = {
+    /* frame 0 */
+    0x21, 0x00, /* ..X....X.. */
+    0x12, 0x00, /* ...X..X... */
+    0x3F, 0x00, /* ..XXXXXX.. */
+    0x6D, 0x80, /* .XX.XX.XX. */
+    0xFF, 0xC0, /* XXXXXXXXXX */
+    0xBF, 0x40, /* X.XXXXXX.X */
+    0xA1, 0x40, /* X.X....X.X */
+    0x1B, 0x00, /* ...XX.XX.. */
+    /* frame 1 */
+    0x21, 0x00, /* ..X....X.. */
+    0x92, 0x40, /* X..X..X..X */
+    0xBF, 0x40, /* X.XXXXXX.X */
+    0xED, 0xC0, /* XXX.XX.XXX */
+    0xFF, 0xC0, /* XXXXXXXXXX */
+    0x7F, 0x80, /* .XXXXXXXX. */
+    0x21, 0x00, /* ..X....X.. */
+    0x40, 0x80, /* .X......X. */
+};
+
+static const uint8_t octopus_data[] = {
+    /* frame 0 */
+    0x1E, 0x00, /* ...XXXX... */
+    0x7F, 0x80, /* .XXXXXXXX. */
+    0xFF, 0xC0, /* XXXXXXXXXX */
+    0xED, 0xC0, /* XXX.XX.XXX */
+    0xFF, 0xC0, /* XXXXXXXXXX */
+    0x33, 0x00, /* ..XX..XX.. */
+    0x6D, 0x80, /* .XX.XX.XX. */
+    0xC0, 0xC0, /* XX......XX */
+    /* frame 1 */
+    0x1E, 0x00, /* ...XXXX... */
+    0x7F, 0x80, /* .XXXXXXXX. */
+    0xFF, 0xC0, /* XXXXXXXXXX */
+    0xED, 0xC0, /* XXX.XX.XXX */
+    0xFF, 0xC0, /* XXXXXXXXXX */
+    0x12, 0x00, /* ...X..X... */
+    0x2D, 0x00, /* ..X.XX.X.. */
+    0x12, 0x00, /* ...X..X... */
+};
+
+const st7735_sprite_t sprite_invaders[INVADER_TYPES] = {
+    { INVADER_WIDTH, INVADER_HEIGHT, 2, ST7735_SPRITE_1BPP, 0xFFFF, 0, squid_data },   /* white */
+    { INVADER_WIDTH, INVADER_HEIGHT, 2, ST7735_SPRITE_1BPP, 0x07FF, 0, crab_data },    /* cyan */
+    { INVADER_WIDTH, INVADER_HEIGHT, 2, ST7735_SPRITE_1BPP, 0x07E0, 0, octopus_data }, /* green */
+};
+
+/* =======================
+   Player (RGB565, 10x5)
+   ======================= */
+#define K 0xF81F /* transparent */
+#define W 0xFFFF
+#define G 0x07E0
+
+static const uint16_t player_data[] = {
+    K, K, K, K, W, W, K, K, K, K,
+    K, K, K, W, W, W, W, K, K, K,
+    K, G, G, G, G, G, G, G, G, K,
+    G, G, G, G, G, G, G, G, G, G,
+    G, G, G, G, G, G, G, G, G, G,
+};
+
+#undef K
+#undef W
+#undef G
+
+const st7735_sprite_t sprite_player = {
+    PLAYER_SPRITE_WIDTH, PLAYER_SPRITE_HEIGHT, 1, ST7735_SPRITE_RGB565, 0, 0xF81F, player_data
+};
@@ -0,0 +1,71 @@
+#include "game/waves.h"
+#include "game/game.h"
+
+#define T(ms) GAME_MS_TO_TICKS(ms)
+
+#define SQUID   0
+#define CRAB    1
+#define OCTOPUS 2
+
+const wave_def_t waves[] = {
+    /* 1: the original 3x6 block */
+    {
+        3, 6, 10, 20, 18, 15, 2, 5,
+        { 0x3F, 0x3F, 0x3F },
+        { SQUID, CRAB, OCTOPUS },
+        { {100, T(300)}, {50, T(200)}, {20, T(100)}, {0, T(30)} },
+        { {100, T(800)}, {50, T(650)}, {20, T(500)}, {0, T(400)} },
+        5, FIX16(80)
+    },
+    /* 2: 26 invaders in a wedge */
+    {
+        4, 8, 8, 20, 14, 13, 2, 5,
+        { 0x3C, 0x7E, 0xFF, 0xFF },
+        { SQUID, CRAB, CRAB, OCTOPUS },
+        { {100, T(250)}, {50, T(160)}, {20, T(70)}, {0, T(25)} },
+        { {100, T(700)}, {50, T(550)}, {20, T(400)}, {0, T(300)} },
+        6, FIX16(85)
+    },
+    /* 3: the arcade's 5x11 */
+    {
+        5, 11, 4, 18, 11, 12, 1, 4,
+        { 0x7FF, 0x7FF, 0x7FF, 0x7FF, 0x7FF },
+        { SQUID, CRAB, CRAB, OCTOPUS, OCTOPUS },
+        { {100, T(200)}, {50, T(100)}, {20, T(40)}, {0, T(10)} },
+        { {100, T(600)}, {50, T(450)}, {20, T(300)}, {0, T(250)} },
+        8, FIX16(90)
+    },
+    /* 4: 66 invaders, repeats from here on */
+    {
+        6, 11, 4, 16, 11, 11, 1, 4,
+        { 0x7FF, 0x7FF, 0x7FF, 0x7FF, 0x7FF, 0x7FF },
+        { SQUID, SQUID, CRAB, CRAB, OCTOPUS, OCTOPUS },
+        { {100, T(170)}, {50, T(80)}, {20, T(30)}, {0, T(10)} },
+        { {100, T(500)}, {50, T(350)}, {20, T(250)}, {0, T(200)} },
+        10, FIX16(95)
+    },
+};
+
+const int wave_count = sizeof(waves) / sizeof(waves[0]);
+
+const wave_def_t *wave_get(int n) {
+    return &waves[n < wave_count ? n : wave_count - 1];
+}
+
+int wave_interval(const wave_point_t *curve, int alive, int total) {
+    if (total <= 0) return curve[WAVE_CURVE_POINTS - 1].ticks;
+
+    /* Compare alive / total with the points' percentages, scaled by
+       100 * total to stay in integers */
+    int share = alive * 100;
+    for (int i = 1; i < WAVE_CURVE_POINTS; i++) {
+        const wave_point_t *hi = &curve[i - 1];
+        const wave_point_t *lo = &curve[i];
+        if (share >= lo->alive * total) {
+            int span = (hi->alive - lo->alive) * total;
+            if (span <= 0) return hi->ticks;
+            return lo->ticks + (hi->ticks - lo->ticks) * (share - lo->alive * total) / span;
+        }
+    }
+    return curve[WAVE_CURVE_POINTS - 1].ticks;
+}
@@ -0,0 +1,136 @@
+#include "hal/audio/pwm_audio.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+
+// Sample buffers. The fill callback writes signed samples, which are then
+// turned into PWM levels in place; the DMA reads the levels.
+static int16_t _buffers[2][PWM_AUDIO_BUFFER_SAMPLES] __attribute__((aligned(4)));
+static int _chan[2] = {-1, -1};
+static int _timer = -1;
+static uint32_t _rate;
+static pwm_audio_fill_t _fill;
+static pwm_audio_stats_t _stats;
+
+// Mixes into buffer i and converts it to unsigned PWM levels
+static void pwm_audio_refill(int i)
+{
+    uint32_t start = time_us_32();
+    int16_t *samples = _buffers[i];
+    _fill(samples, PWM_AUDIO_BUFFER_SAMPLES);
+    uint16_t *levels = (uint16_t *)samples;
+    for (int k = 0; k < PWM_AUDIO_BUFFER_SAMPLES; k++)
+    {
+        levels[k] = (uint16_t)((samples[k] + 32768) >> (16 - PWM_AUDIO_BITS));
+    }
+
+    uint32_t us = time_us_32() - start;
+    _stats.buffers++;
+    _stats.fill_us_last = us;
+    _stats.fill_us_total += us;
+    if (us > _stats.fill_us_max)
+    {
+        _stats.fill_us_max = us;
+    }
+    if (us > _stats.budget_us)
+    {
+        _stats.over_budget++;
+    }
+}
+
+// A channel finished its buffer and the other one is playing: rewind the
+// finished channel (it starts again when the other chains to it) and refill
+// its buffer within the other's play time
+static void pwm_audio_irq(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (dma_channel_get_irq1_status(_chan[i]))
+        {
+            dma_channel_acknowledge_irq1(_chan[i]);
+            dma_channel_set_read_addr(_chan[i], _buffers[i], false);
+            pwm_audio_refill(i);
+        }
+    }
+}
+
+bool pwm_audio_init(uint pin, uint32_t sample_rate, pwm_audio_fill_t fill)
+{
+    _timer = dma_claim_unused_timer(false);
+    _chan[0] = dma_claim_unused_channel(false);
+    _chan[1] = dma_claim_unused_channel(false);
+    if (_timer < 0 || _chan[0] < 0 || _chan[1] < 0)
+    {
+        // Give back whatever was claimed
+        if (_timer >= 0)
+        {
+            dma_timer_unclaim(_timer);
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            if (_chan[i] >= 0)
+            {
+                dma_channel_unclaim(_chan[i]);
+            }
+            _chan[i] = -1;
+        }
+        _timer = -1;
+        return false;
+    }
+    _fill = fill;
+
+    // PWM at full system clock; the level is the compare value
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    uint slice = pwm_gpio_to_slice_num(pin);
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv(&config, 1.0f);
+    pwm_config_set_wrap(&config, (1u << PWM_AUDIO_BITS) - 1);
+    pwm_init(slice, &config, true);
+    pwm_set_gpio_level(pin, 1u << (PWM_AUDIO_BITS - 1));
+
+    // The timer fires at clk_sys * 1 / divider
+    uint32_t clk = clock_get_hz(clk_sys);
+    uint32_t divider = (clk + sample_rate / 2) / sample_rate;
+    if (divider > 0xFFFF)
+    {
+        divider = 0xFFFF;
+    }
+    dma_timer_set_fraction(_timer, 1, divider);
+    _rate = clk / divider;
+    _stats = (pwm_audio_stats_t){0};
+    _stats.budget_us = (uint32_t)(PWM_AUDIO_BUFFER_SAMPLES * 1000000ull / _rate);
+
+    // 16-bit writes are replicated to both halves of the compare register,
+    // so one address serves either PWM channel of the slice
+    for (int i = 0; i < 2; i++)
+    {
+        dma_channel_config c = dma_channel_get_default_config(_chan[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, dma_get_timer_dreq(_timer));
+        channel_config_set_chain_to(&c, _chan[i ^ 1]);
+        dma_channel_configure(_chan[i], &c, &pwm_hw->slice[slice].cc, _buffers[i], PWM_AUDIO_BUFFER_SAMPLES,
+                              false);
+        dma_channel_set_irq1_enabled(_chan[i], true);
+    }
+
+    pwm_audio_refill(0);
+    pwm_audio_refill(1);
+    irq_add_shared_handler(DMA_IRQ_1, pwm_audio_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    dma_channel_start(_chan[0]);
+    return true;
+}
+
+uint32_t pwm_audio_sample_rate(void)
+{
+    return _rate;
+}
+
+void pwm_audio_get_stats(pwm_audio_stats_t *stats)
+{
+    // Written by the interrupt; a torn read only skews one report
+    *stats = _stats;
+}
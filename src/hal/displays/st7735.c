@@ -2,10 +2,13 @@
 
 #include "hal/displays/st7735.h"
 #include "hardware/gpio.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/sync.h"
+#include "pico/multicore.h"
 #include "pico/time.h"
 #include <string.h>
-#include <stdlib.h>
-#include <stdio.h>
+#include "st7735.pio.h"
 
 // ST7735 commands
 #define DELAY 0x80
@@ -70,6 +73,132 @@ static int _width;
 static int _height;
 static uint8_t _color_mode;
 
+// Optional RAM framebuffers. Pixels are stored in panel byte order (high byte
+// first in memory), so a frame can be streamed to the SPI TX FIFO as-is.
+// The second buffer is only used in pipelined mode, where core 0 draws into
+// the back buffer while core 1 sends the other one. Build with
+// ST7735_FRAMEBUFFER=0 to leave them out (80 KB); direct drawing and the
+// strip renderer still work then.
+#ifndef ST7735_FRAMEBUFFER
+#define ST7735_FRAMEBUFFER 1
+#endif
+#define ST7735_FB_PIXELS (ST7735_FRAMEBUFFER ? ST7735_TFTWIDTH * ST7735_TFTHEIGHT : 1)
+
+static uint16_t _framebuffers[2][ST7735_FB_PIXELS] __attribute__((aligned(4)));
+static int _back = 0;
+static uint16_t *_fb = _framebuffers[0]; // buffer drawing calls render into
+static bool _fb_enabled = false;
+static int _dma_chan = -1;
+static bool _dma_active = false;
+static bool _dma_16bit = false; // running transfer uses 16-bit SPI frames
+static uint16_t _fill_color;    // DMA source of solid fills, must outlive the transfer
+static uint32_t _fill_pair;     // the same for PIO fills: one color in both halves
+
+// Dirty-rectangle tracking (framebuffer mode only). Every draw call records
+// the area it touched. st7735_present() then sends the union of the areas
+// drawn in this frame and the previous one instead of the whole screen.
+#define ST7735_MAX_DIRTY_RECTS 192
+
+typedef struct
+{
+    int16_t x, y, w, h;
+    uint32_t tag; // solid fill color + 1, sprite tag (bit 31 set), 0 if not comparable
+} st7735_rect_t;
+
+static bool _dirty_enabled = false;
+static st7735_rect_t _drawn[2][ST7735_MAX_DIRTY_RECTS]; // per buffer, drawn since its last clear
+static int _drawn_count[2] = {0, 0};
+static st7735_rect_t _shown[ST7735_MAX_DIRTY_RECTS]; // drawn in the frame on the panel
+static int _shown_count = 0;
+static bool _full_redraw = true; // screen clear or rect overflow: send everything
+static bool _drawn_overflow[2] = {false, false}; // more draws than slots: erase the whole buffer next frame
+static bool _shown_overflow = false; // _shown is incomplete: the next frame is sent in full
+static uint32_t _bytes_sent = 0;
+
+// Pipelined mode: present() hands the back buffer and its region list to
+// core 1 through the inter-core FIFO. The two counters are each written by
+// one core only, so comparing them needs no lock.
+static bool _pipelined = false;
+static bool _core1_launched = false;
+static st7735_rect_t _job_regions[2][2 * ST7735_MAX_DIRTY_RECTS];
+static int _job_count[2];                  // regions per buffer, -1 = full screen
+static volatile uint32_t _frames_queued = 0;  // written by core 0
+static volatile uint32_t _frames_flushed = 0; // written by core 1
+static uint32_t _frames_stalled = 0;
+static uint64_t _stall_us = 0;
+
+// Strip renderer: drawing calls are recorded in a per-frame command list and
+// st7735_present() rasterizes it ST7735_STRIP_LINES lines at a time into two
+// small ping-pong buffers, sending one strip by DMA while the next is drawn.
+// A strip whose commands hash the same as last frame is not sent again.
+#define ST7735_STRIP_LINES 16
+#define ST7735_STRIP_WIDTH (ST7735_TFTWIDTH > ST7735_TFTHEIGHT ? ST7735_TFTWIDTH : ST7735_TFTHEIGHT)
+#define ST7735_MAX_STRIPS ((ST7735_STRIP_WIDTH + ST7735_STRIP_LINES - 1) / ST7735_STRIP_LINES)
+#define ST7735_MAX_CMDS 256
+#define ST7735_TEXT_POOL 512
+
+enum
+{
+    ST7735_CMD_FILL,
+    ST7735_CMD_TEXT,
+    ST7735_CMD_SPRITE,
+    ST7735_CMD_BUFFER,
+    ST7735_CMD_POINTS
+};
+
+typedef struct
+{
+    int16_t x, y, w, h; // clipped screen area
+    int16_t sx, sy;     // where that area starts in the source
+    uint8_t type;
+    uint8_t frame;      // sprite frame
+    uint16_t color;     // fill or text color, panel byte order
+    uint16_t bg_color;  // text background, panel byte order
+    uint16_t stride;    // pixel buffer row length, or number of points
+    const void *src;    // text (in _text_pool), sprite, pixel buffer or points
+    uint32_t tag;       // caller's sprite content tag, hashed instead of src if set
+} st7735_cmd_t;
+
+static bool _strip_enabled = false;
+static uint16_t _strips[2][ST7735_STRIP_WIDTH * ST7735_STRIP_LINES] __attribute__((aligned(4)));
+static int _strip_buf = 0; // strip buffer rasterized next (the other one may be on the bus)
+static st7735_cmd_t _cmds[ST7735_MAX_CMDS]; // further commands in a frame are dropped
+static int _cmd_count = 0;
+static char _text_pool[ST7735_TEXT_POOL];
+static int _text_used = 0;
+static uint16_t _strip_bg = 0; // panel byte order
+static uint32_t _strip_hash[ST7735_MAX_STRIPS];
+static bool _strip_hash_valid = false;
+static uint32_t _strip_frame = 0; // pixel buffers may change behind our back
+
+// PIO interface (see pio/st7735.pio). The state machine drives CS, SCK, MOSI
+// and D/C from framed words, so a whole flush (windows, commands and pixel
+// runs) is one display list walked by two chained DMA channels: the control
+// channel loads {count, address} blocks into the data channel, which feeds
+// the words to the TX FIFO.
+#define ST7735_DL_MAX_BLOCKS 640
+#define ST7735_DL_MAX_WORDS 2048
+#define ST7735_DL_SETUP_WORDS 11
+
+typedef struct
+{
+    uint32_t count;     // words to transfer, 0 ends the list
+    const void *addr;
+} st7735_dl_block_t;
+
+static bool _pio_enabled = false;
+static PIO _pio;
+static int _pio_sm = -1;
+static int _pio_offset = -1;
+static uint _pio_sck_pin;
+static uint _pio_mosi_pin;
+static int _dl_data_chan = -1;
+static int _dl_ctrl_chan = -1;
+static st7735_dl_block_t _dl_blocks[ST7735_DL_MAX_BLOCKS];
+static uint32_t _dl_words[ST7735_DL_MAX_WORDS]; // headers and command bytes
+static int _dl_block_count;
+static int _dl_word_count;
+
 // Font 5x7 pixels
 static const uint8_t font5x7[480] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5f, 0x00, 0x00, 0x00, 0x07,
@@ -113,53 +242,356 @@ static const uint8_t font5x7[480] = {
     0x08, 0x36, 0x41, 0x00, 0x00, 0x00, 0x7f, 0x00, 0x00, 0x00, 0x41, 0x36,
     0x08, 0x00, 0x08, 0x08, 0x2a, 0x1c, 0x08, 0x08, 0x1c, 0x2a, 0x08, 0x08};
 
+// Glyph atlas built from font5x7 on first use: 8 rows per character, each a
+// 6-bit mask (bit i = column i, column 5 is the spacing column). Text is
+// rendered row by row from it, one address window per string.
+#define ST7735_GLYPH_COUNT (sizeof(font5x7) / 5)
+#define ST7735_GLYPH_WIDTH 6
+#define ST7735_GLYPH_HEIGHT 8
+
+static uint8_t _glyph_rows[ST7735_GLYPH_COUNT][ST7735_GLYPH_HEIGHT];
+static bool _glyphs_ready = false;
+
+// Pixels of one text line or sprite band in direct mode, sent with a single transfer
+#define ST7735_BLIT_PIXELS ((ST7735_TFTWIDTH > ST7735_TFTHEIGHT ? ST7735_TFTWIDTH : ST7735_TFTHEIGHT) * \
+                            ST7735_GLYPH_HEIGHT)
+static uint16_t _blit_buffer[ST7735_BLIT_PIXELS];
+
+// Waits until core 1 has sent every queued frame. Only called on core 0.
+static void st7735_pipeline_wait(void)
+{
+    if (_frames_flushed == _frames_queued)
+    {
+        return;
+    }
+
+    uint64_t start = time_us_64();
+    while (_frames_flushed != _frames_queued)
+    {
+        tight_loop_contents();
+    }
+    __dmb();
+    _frames_stalled++;
+    _stall_us += time_us_64() - start;
+}
+
+// Frame header for the PIO program: D/C level and bit count - 1.
+static inline uint32_t st7735_pio_header(bool dc, uint32_t bits)
+{
+    return ((uint32_t)dc << 31) | (bits - 1);
+}
+
+// True once the display list is out and the state machine waits for a frame.
+static bool st7735_pio_idle(void)
+{
+    return !dma_channel_is_busy(_dl_ctrl_chan) && !dma_channel_is_busy(_dl_data_chan) &&
+           !dma_channel_is_busy(_dma_chan) &&
+           pio_sm_is_tx_fifo_empty(_pio, _pio_sm) &&
+           pio_sm_get_pc(_pio, _pio_sm) == (uint)_pio_offset + st7735_lcd_offset_start;
+}
+
+// Sends one frame through the PIO FIFO from the CPU (used outside display lists).
+static void st7735_pio_write(bool dc, const uint8_t *buffer, size_t len)
+{
+    pio_sm_put_blocking(_pio, _pio_sm, st7735_pio_header(dc, len * 8));
+    while (len > 0)
+    {
+        uint32_t word = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            word <<= 8;
+            if (len > 0)
+            {
+                word |= *buffer++;
+                len--;
+            }
+        }
+        pio_sm_put_blocking(_pio, _pio_sm, word);
+    }
+}
+
+// Waits for a running framebuffer transfer and releases the bus.
+static void st7735_dma_wait(void)
+{
+    if (_pipelined && get_core_num() == 0)
+    {
+        // Core 1 owns the bus while it has frames to send
+        st7735_pipeline_wait();
+    }
+    if (!_dma_active)
+    {
+        return;
+    }
+
+    if (_pio_enabled)
+    {
+        // The state machine releases CS itself after the last frame
+        while (!st7735_pio_idle())
+        {
+            tight_loop_contents();
+        }
+        _dma_active = false;
+        return;
+    }
+
+    dma_channel_wait_for_finish_blocking(_dma_chan);
+    while (spi_is_busy(_spi))
+    {
+        tight_loop_contents();
+    }
+    // The TX-only DMA leaves stale bytes in the RX FIFO; drain them and clear the overrun flag
+    while (spi_is_readable(_spi))
+    {
+        (void)spi_get_hw(_spi)->dr;
+    }
+    spi_get_hw(_spi)->icr = SPI_SSPICR_RORIC_BITS;
+    if (_dma_16bit)
+    {
+        spi_set_format(_spi, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+        _dma_16bit = false;
+    }
+    gpio_put(_ce_pin, 1);
+    _dma_active = false;
+}
+
+// Starts a DMA transfer into the SPI TX FIFO. CS must already be asserted;
+// st7735_dma_wait() releases it. A solid transfer re-reads one 16-bit value
+// count times with the SPI in 16-bit mode, a normal one streams count bytes.
+static void st7735_dma_start(const volatile void *src, uint32_t count, bool solid)
+{
+    dma_channel_config c = dma_channel_get_default_config(_dma_chan);
+    channel_config_set_transfer_data_size(&c, solid ? DMA_SIZE_16 : DMA_SIZE_8);
+    channel_config_set_read_increment(&c, !solid);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, spi_get_dreq(_spi, true));
+
+    if (solid)
+    {
+        spi_set_format(_spi, 16, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+    }
+    _dma_16bit = solid;
+    _dma_active = true;
+    dma_channel_configure(_dma_chan, &c, &spi_get_hw(_spi)->dr, src, count, true);
+}
+
+// Waits until the draw buffer may be written. In pipelined mode core 1 only
+// ever reads the front buffer, so drawing never has to wait.
+static void st7735_fb_acquire(void)
+{
+    if (!_pipelined)
+    {
+        st7735_dma_wait();
+    }
+}
+
+// Converts a RGB565 color to the byte order used in the framebuffer.
+static inline uint16_t st7735_fb_color(uint16_t color)
+{
+    return (uint16_t)((color >> 8) | (color << 8));
+}
+
+// Clips a rectangle to the screen. Returns false if nothing is left.
+static bool st7735_clip_rect(int *x, int *y, int *w, int *h)
+{
+    if (*x < 0)
+    {
+        *w += *x;
+        *x = 0;
+    }
+    if (*y < 0)
+    {
+        *h += *y;
+        *y = 0;
+    }
+    if ((*x + *w) > _width)
+    {
+        *w = _width - *x;
+    }
+    if ((*y + *h) > _height)
+    {
+        *h = _height - *y;
+    }
+    return (*w > 0) && (*h > 0);
+}
+
+// Fills w x h pixels of a buffer with a color in panel byte order.
+static void st7735_fill_pixels(uint16_t *dst, int stride, int w, int h, uint16_t color)
+{
+    for (int j = 0; j < h; j++, dst += stride)
+    {
+        for (int i = 0; i < w; i++)
+        {
+            dst[i] = color;
+        }
+    }
+}
+
+// Fills a (clipped) rectangle of the framebuffer.
+static void st7735_fb_fill(int x, int y, int w, int h, uint16_t color)
+{
+    st7735_fill_pixels(&_fb[y * _width + x], _width, w, h, st7735_fb_color(color));
+}
+
+// Appends a command for a clipped area to the strip renderer's list.
+// Returns NULL if the list is full.
+static st7735_cmd_t *st7735_strip_cmd(int type, int x, int y, int w, int h, int sx, int sy)
+{
+    if (_cmd_count >= ST7735_MAX_CMDS)
+    {
+        return NULL;
+    }
+    st7735_cmd_t *cmd = &_cmds[_cmd_count++];
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->type = type;
+    cmd->x = x;
+    cmd->y = y;
+    cmd->w = w;
+    cmd->h = h;
+    cmd->sx = sx;
+    cmd->sy = sy;
+    return cmd;
+}
+
+// Records a (clipped) framebuffer area as touched in the current frame.
+static void st7735_mark_dirty(int x, int y, int w, int h, uint32_t tag)
+{
+    if (!_dirty_enabled)
+    {
+        return;
+    }
+    if (_drawn_count[_back] >= ST7735_MAX_DIRTY_RECTS)
+    {
+        _full_redraw = true;
+        _drawn_overflow[_back] = true;
+        return;
+    }
+
+    st7735_rect_t *r = &_drawn[_back][_drawn_count[_back]++];
+    r->x = x;
+    r->y = y;
+    r->w = w;
+    r->h = h;
+    r->tag = tag;
+}
+
+static bool st7735_rect_equal(const st7735_rect_t *a, const st7735_rect_t *b)
+{
+    return a->x == b->x && a->y == b->y && a->w == b->w && a->h == b->h && a->tag == b->tag;
+}
+
+// True if the rectangles overlap or touch each other.
+static bool st7735_rect_adjacent(const st7735_rect_t *a, const st7735_rect_t *b)
+{
+    return a->x <= b->x + b->w && b->x <= a->x + a->w &&
+           a->y <= b->y + b->h && b->y <= a->y + a->h;
+}
+
+static void st7735_rect_union(st7735_rect_t *a, const st7735_rect_t *b)
+{
+    int x0 = a->x < b->x ? a->x : b->x;
+    int y0 = a->y < b->y ? a->y : b->y;
+    int x1 = (a->x + a->w) > (b->x + b->w) ? (a->x + a->w) : (b->x + b->w);
+    int y1 = (a->y + a->h) > (b->y + b->h) ? (a->y + a->h) : (b->y + b->h);
+    a->x = x0;
+    a->y = y0;
+    a->w = x1 - x0;
+    a->h = y1 - y0;
+    a->tag = 0;
+}
+
+// Writes bytes with the given D/C level inside an open transaction. With the
+// PIO interface every call becomes one frame; the panel keeps the RAMWR
+// state across the CS pulses between frames.
+static void st7735_bus_write(bool dc, const uint8_t *buffer, size_t len)
+{
+    if (len == 0)
+    {
+        return;
+    }
+    if (_pio_enabled)
+    {
+        st7735_pio_write(dc, buffer, len);
+    }
+    else
+    {
+        gpio_put(_dc_pin, dc);
+        spi_write_blocking(_spi, buffer, len);
+    }
+    _bytes_sent += len;
+}
+
 // Sends a command (DC=low) to the display.
 static void st7735_write_cmd(uint8_t cmd)
 {
-    gpio_put(_dc_pin, 0);
+    st7735_dma_wait();
     gpio_put(_ce_pin, 0);
-    spi_write_blocking(_spi, &cmd, 1);
+    st7735_bus_write(0, &cmd, 1);
     gpio_put(_ce_pin, 1);
 }
 
 // Sends data (DC=high) to the display.
 static void st7735_write_data(uint8_t data)
 {
-    gpio_put(_dc_pin, 1);
+    st7735_dma_wait();
     gpio_put(_ce_pin, 0);
-    spi_write_blocking(_spi, &data, 1);
+    st7735_bus_write(1, &data, 1);
     gpio_put(_ce_pin, 1);
 }
 
 // Sends a buffer of data (DC=high).
 void st7735_write_data_buffer(const uint8_t *buffer, size_t len)
 {
-    gpio_put(_dc_pin, 1);
+    st7735_dma_wait();
     gpio_put(_ce_pin, 0);
-    spi_write_blocking(_spi, buffer, len);
+    st7735_bus_write(1, buffer, len);
     gpio_put(_ce_pin, 1);
 }
 
-// Sets the address window for pixel operations.
-void st7735_set_addr_window(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+// Opens one transaction that sets the address window (CASET, RASET) and
+// starts RAMWR. CS stays asserted and DC high, so pixel data can follow
+// directly; st7735_end_write() (or st7735_dma_wait() after a DMA transfer)
+// closes the transaction. DC only changes where the byte type changes.
+void st7735_begin_write(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    const uint8_t caset_cmd = ST7735_CASET;
+    const uint8_t caset[4] = {0x00, x0 + _offset, 0x00, x1 + _offset};
+    const uint8_t raset_cmd = ST7735_RASET;
+    const uint8_t raset[4] = {0x00, y0 + _offset, 0x00, y1 + _offset};
+    const uint8_t ramwr = ST7735_RAMWR;
+
+    st7735_dma_wait();
+    gpio_put(_ce_pin, 0);
+    st7735_bus_write(0, &caset_cmd, 1);
+    st7735_bus_write(1, caset, sizeof(caset));
+    st7735_bus_write(0, &raset_cmd, 1);
+    st7735_bus_write(1, raset, sizeof(raset));
+    st7735_bus_write(0, &ramwr, 1);
+    gpio_put(_dc_pin, 1);
+}
+
+// Sends pixel bytes inside a transaction opened by st7735_begin_write().
+void st7735_write_pixels(const uint8_t *buffer, size_t len)
 {
-    st7735_write_cmd(ST7735_CASET); // Column addr set
-    st7735_write_data(0x00);
-    st7735_write_data(x0 + _offset); // XSTART
-    st7735_write_data(0x00);
-    st7735_write_data(x1 + _offset); // XEND
+    st7735_bus_write(1, buffer, len);
+}
 
-    st7735_write_cmd(ST7735_RASET); // Row addr set
-    st7735_write_data(0x00);
-    st7735_write_data(y0 + _offset); // YSTART
-    st7735_write_data(0x00);
-    st7735_write_data(y1 + _offset); // YEND
+void st7735_end_write(void)
+{
+    gpio_put(_ce_pin, 1);
+}
 
-    st7735_write_cmd(ST7735_RAMWR); // write to RAM
+// Sets the address window for pixel operations.
+void st7735_set_addr_window(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+    st7735_begin_write(x0, y0, x1, y1);
+    st7735_end_write();
 }
 
 void st7735_init(spi_inst_t *spi, uint rst_pin, uint ce_pin, uint dc_pin, uint offset, bool is_bgr)
 {
+    // Hand the old pins back before they change
+    st7735_release_pio();
+
     _spi = spi;
     _rst_pin = rst_pin;
     _ce_pin = ce_pin;
@@ -189,6 +621,12 @@ void st7735_init(spi_inst_t *spi, uint rst_pin, uint ce_pin, uint dc_pin, uint o
 
     gpio_put(_ce_pin, 1);
     gpio_put(_dc_pin, 1);
+
+    // One DMA channel feeds the SPI TX FIFO for fills and framebuffer flushes
+    if (_dma_chan < 0)
+    {
+        _dma_chan = dma_claim_unused_channel(true);
+    }
 }
 
 void st7735_reset()
@@ -312,64 +750,109 @@ void st7735_draw_pixel(int x, int y, uint16_t color)
         return;
     }
 
-    st7735_set_addr_window(x, y, x, y);
+    if (_strip_enabled)
+    {
+        st7735_cmd_t *cmd = st7735_strip_cmd(ST7735_CMD_FILL, x, y, 1, 1, 0, 0);
+        if (cmd)
+        {
+            cmd->color = st7735_fb_color(color);
+        }
+        return;
+    }
+    if (_fb_enabled)
+    {
+        st7735_fb_acquire();
+        _fb[y * _width + x] = st7735_fb_color(color);
+        st7735_mark_dirty(x, y, 1, 1, color + 1u);
+        return;
+    }
+
     uint8_t data[2] = {color >> 8, color & 0xFF};
-    st7735_write_data_buffer(data, 2);
+    st7735_begin_write(x, y, x, y);
+    st7735_write_pixels(data, 2);
+    st7735_end_write();
 }
 
 void st7735_fill_rect(int x, int y, int w, int h, uint16_t color)
 {
-    if ((x >= _width) || (y >= _height))
+    if (!st7735_clip_rect(&x, &y, &w, &h))
     {
         return;
     }
-    if ((x + w - 1) >= _width)
-    {
-        w = _width - x;
-    }
-    if ((y + h - 1) >= _height)
-    {
-        h = _height - y;
-    }
-
-    st7735_set_addr_window(x, y, x + w - 1, y + h - 1);
 
-    // Create buffer for ONE line
-    size_t line_buffer_size = w * 2;
-    uint8_t *line_buffer = (uint8_t *)malloc(line_buffer_size);
-    if (!line_buffer)
+    if (_strip_enabled)
     {
-        // Memory error, possibly abort
+        st7735_cmd_t *cmd = st7735_strip_cmd(ST7735_CMD_FILL, x, y, w, h, 0, 0);
+        if (cmd)
+        {
+            cmd->color = st7735_fb_color(color);
+        }
         return;
     }
-
-    // Fill the line buffer
-    for (int i = 0; i < w; i++)
+    if (_fb_enabled)
     {
-        line_buffer[i * 2] = color >> 8;       // High-Byte
-        line_buffer[i * 2 + 1] = color & 0xFF; // Low-Byte
+        st7735_fb_acquire();
+        st7735_fb_fill(x, y, w, h, color);
+        st7735_mark_dirty(x, y, w, h, color + 1u);
+        return;
     }
 
-    // Send the line buffer h times
-    gpio_put(_dc_pin, 1);
-    gpio_put(_ce_pin, 0);
-    for (int j = 0; j < h; j++)
+    // The DMA reads the same color w*h times; the call returns while the
+    // fill runs, the next display access waits for it (see st7735_is_busy)
+    st7735_begin_write(x, y, x + w - 1, y + h - 1);
+    _bytes_sent += w * h * 2;
+    if (_pio_enabled)
     {
-        spi_write_blocking(_spi, line_buffer, line_buffer_size);
+        // PIO frames carry their length up front; after the header the DMA
+        // reads the color pair (pixels + 1) / 2 times, the odd half is dropped
+        uint32_t pixels = w * h;
+        pio_sm_put_blocking(_pio, _pio_sm, st7735_pio_header(1, pixels * 16));
+        _fill_pair = ((uint32_t)color << 16) | color;
+        dma_channel_config c = dma_channel_get_default_config(_dma_chan);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, pio_get_dreq(_pio, _pio_sm, true));
+        _dma_active = true;
+        dma_channel_configure(_dma_chan, &c, &_pio->txf[_pio_sm], &_fill_pair, (pixels + 1) / 2, true);
+        return;
     }
-    gpio_put(_ce_pin, 1);
-
-    free(line_buffer);
+    _fill_color = color;
+    st7735_dma_start(&_fill_color, w * h, true);
 }
 
 void st7735_fill_screen(uint16_t color)
 {
+    if (_strip_enabled)
+    {
+        // A new frame: everything recorded so far is covered
+        _cmd_count = 0;
+        _text_used = 0;
+        _strip_bg = st7735_fb_color(color);
+        return;
+    }
+    if (_fb_enabled)
+    {
+        // Everything changes; replace the individual rectangles by one
+        st7735_fb_acquire();
+        st7735_fb_fill(0, 0, _width, _height, color);
+        _drawn_count[_back] = 0;
+        _drawn_overflow[_back] = false;
+        st7735_mark_dirty(0, 0, _width, _height, color + 1u);
+        if (_pipelined)
+        {
+            // The other buffer missed the clear
+            _drawn_overflow[_back ^ 1] = true;
+        }
+        _full_redraw = true;
+        return;
+    }
     st7735_fill_rect(0, 0, _width, _height, color);
 }
 
 void st7735_draw_buffer(int x, int y, int w, int h, const uint8_t *buffer)
 {
-    printf("Draw BMP at (%d,%d) size %dx%d\n", x, y, w, h);
+    int stride = w * 2;
     if ((x >= _width) || (y >= _height))
     {
         return;
@@ -383,78 +866,361 @@ void st7735_draw_buffer(int x, int y, int w, int h, const uint8_t *buffer)
         h = _height - y;
     }
 
-    st7735_set_addr_window(x, y, x + w - 1, y + h - 1);
-    st7735_write_data_buffer(buffer, w * h * 2);
+    if (_strip_enabled || _fb_enabled)
+    {
+        if (x < 0 || y < 0)
+        {
+            return;
+        }
+    }
+    if (_strip_enabled)
+    {
+        // The buffer is read at present() time, so it must stay valid until then
+        st7735_cmd_t *cmd = st7735_strip_cmd(ST7735_CMD_BUFFER, x, y, w, h, 0, 0);
+        if (cmd)
+        {
+            cmd->stride = stride / 2;
+            cmd->src = buffer;
+        }
+        return;
+    }
+    if (_fb_enabled)
+    {
+        st7735_fb_acquire();
+        // The buffer is already in panel byte order, so rows can be copied 1:1
+        for (int j = 0; j < h; j++)
+        {
+            memcpy(&_fb[(y + j) * _width + x], buffer, w * 2);
+            buffer += stride;
+        }
+        st7735_mark_dirty(x, y, w, h, 0);
+        return;
+    }
+
+    st7735_begin_write(x, y, x + w - 1, y + h - 1);
+    st7735_write_pixels(buffer, w * h * 2);
+    st7735_end_write();
 }
 
-void st7735_draw_char(int x, int y, char ch, uint16_t color, uint16_t bg_color)
+// Transposes the column-major font into the row masks of the atlas.
+static void st7735_build_glyphs(void)
 {
-    // Valid range of the font (ASCII 0x20 to 0x7F)
-    if (ch < 0x20 || ch > 0x7F)
+    for (size_t g = 0; g < ST7735_GLYPH_COUNT; g++)
     {
-        ch = 0x20; // Show space for invalid characters
+        for (int col = 0; col < 5; col++)
+        {
+            uint8_t bits = font5x7[g * 5 + col];
+            for (int row = 0; row < ST7735_GLYPH_HEIGHT; row++)
+            {
+                _glyph_rows[g][row] |= ((bits >> row) & 1) << col;
+            }
+        }
     }
+    _glyphs_ready = true;
+}
 
-    // 6x8 pixel buffer (6 columns, 8 rows, 2 bytes/pixel)
-    uint8_t char_image[6 * 8 * 2];
-
-    // Pointer to the 5 bytes of the character in the font
-    const uint8_t *glyph = &font5x7[(ch - 0x20) * 5];
+static inline const uint8_t *st7735_glyph(char ch)
+{
+    unsigned char c = (unsigned char)ch;
+    // Valid range of the font (ASCII 0x20 to 0x7F), space for anything else
+    if (c < 0x20 || c >= 0x20 + ST7735_GLYPH_COUNT)
+    {
+        c = 0x20;
+    }
+    return _glyph_rows[c - 0x20];
+}
 
-    // Add the 6th column (space)
-    uint8_t glyph_with_space[6];
-    memcpy(glyph_with_space, glyph, 5);
-    glyph_with_space[5] = 0x00; // Last column is always empty
+// Renders the text pixels [col0, col0 + cols) x [row0, row0 + rows) of a
+// string into dst. Colors are in panel byte order.
+static void st7735_render_text(uint16_t *dst, int stride, const char *str, int col0, int cols, int row0,
+                               int rows, uint16_t color, uint16_t bg_color)
+{
+    const char *first = str + col0 / ST7735_GLYPH_WIDTH;
+    int first_bit = col0 % ST7735_GLYPH_WIDTH;
 
-    int buf_idx = 0;
-    for (int j = 0; j < 8; j++)
-    { // Iterate over bits/rows (0-7)
-        for (int i = 0; i < 6; i++)
-        { // Iterate over bytes/columns (0-5)
-            if ((glyph_with_space[i] >> j) & 1)
+    for (int j = 0; j < rows; j++)
+    {
+        uint16_t *p = dst + j * stride;
+        const char *c = first;
+        int bit = first_bit;
+        int left = cols;
+        while (left > 0)
+        {
+            uint8_t mask = st7735_glyph(*c++)[row0 + j] >> bit;
+            int n = ST7735_GLYPH_WIDTH - bit;
+            if (n > left)
             {
-                // Foreground
-                // CORRECTION 3A
-                char_image[buf_idx++] = color >> 8;   // High-Byte
-                char_image[buf_idx++] = color & 0xFF; // Low-Byte
+                n = left;
             }
-            else
+            left -= n;
+            while (n--)
             {
-                // Background
-                // CORRECTION 3B
-                char_image[buf_idx++] = bg_color >> 8;   // High-Byte
-                char_image[buf_idx++] = bg_color & 0xFF; // Low-Byte
+                *p++ = (mask & 1) ? color : bg_color;
+                mask >>= 1;
             }
+            bit = 0;
         }
     }
+}
 
-    st7735_draw_buffer(x, y, 6, 8, char_image);
+void st7735_draw_char(int x, int y, char ch, uint16_t color, uint16_t bg_color)
+{
+    const char str[2] = {ch, '\0'};
+    st7735_draw_string(x, y, str, color, bg_color);
 }
 
 void st7735_draw_string(int x, int y, const char *str, uint16_t color, uint16_t bg_color)
 {
-    while (*str)
+    if (!_glyphs_ready)
+    {
+        st7735_build_glyphs();
+    }
+
+    int w = (int)strlen(str) * ST7735_GLYPH_WIDTH;
+    int h = ST7735_GLYPH_HEIGHT;
+    int text_x = x, text_y = y;
+    if (!st7735_clip_rect(&x, &y, &w, &h))
+    {
+        return;
+    }
+
+    uint16_t fg = st7735_fb_color(color);
+    uint16_t bg = st7735_fb_color(bg_color);
+    if (_strip_enabled)
+    {
+        // Keep a copy of the visible characters; the caller's string may not outlive the frame
+        int col0 = x - text_x;
+        int first = col0 / ST7735_GLYPH_WIDTH;
+        int chars = (col0 % ST7735_GLYPH_WIDTH + w + ST7735_GLYPH_WIDTH - 1) / ST7735_GLYPH_WIDTH;
+        if (_text_used + chars + 1 > ST7735_TEXT_POOL)
+        {
+            return;
+        }
+        st7735_cmd_t *cmd = st7735_strip_cmd(ST7735_CMD_TEXT, x, y, w, h, col0 % ST7735_GLYPH_WIDTH, y - text_y);
+        if (cmd)
+        {
+            char *text = &_text_pool[_text_used];
+            memcpy(text, str + first, chars);
+            text[chars] = '\0';
+            _text_used += chars + 1;
+            cmd->color = fg;
+            cmd->bg_color = bg;
+            cmd->src = text;
+        }
+        return;
+    }
+    if (_fb_enabled)
     {
-        st7735_draw_char(x, y, *str, color, bg_color);
-        x += 6; // Width of each character
-        str++;
+        st7735_fb_acquire();
+        st7735_render_text(&_fb[y * _width + x], _width, str, x - text_x, w, y - text_y, h, fg, bg);
+        st7735_mark_dirty(x, y, w, h, 0);
+        return;
     }
+
+    st7735_render_text(_blit_buffer, w, str, x - text_x, w, y - text_y, h, fg, bg);
+    st7735_begin_write(x, y, x + w - 1, y + h - 1);
+    st7735_write_pixels((const uint8_t *)_blit_buffer, w * h * 2);
+    st7735_end_write();
 }
 
-void st7735_set_rotation(uint8_t m)
+// Dirty-rect tag of a sprite frame. Bit 31 keeps it apart from fill colors,
+// so an animation frame drawn at the same place twice is not resent.
+static uint32_t st7735_sprite_tag(const st7735_sprite_t *sprite, int frame)
 {
-    st7735_write_cmd(ST7735_MADCTL);
-    uint8_t rotation = m % 4; // 0, 1, 2, 3
+    uint32_t h = (uint32_t)(uintptr_t)sprite * 2654435761u;
+    h ^= (uint32_t)(frame + 1) * 0x9E3779B9u;
+    return h | 0x80000000u;
+}
 
-    switch (rotation)
+// Blits rows [sy, sy + h) and columns [sx, sx + w) of a sprite frame into dst.
+// Transparent pixels are skipped, or set to bg_color if opaque is true.
+static void st7735_blit_sprite(uint16_t *dst, int stride, const st7735_sprite_t *sprite, int frame, int sx,
+                               int sy, int w, int h, bool opaque, uint16_t bg_color)
+{
+    if (sprite->format == ST7735_SPRITE_1BPP)
     {
-    case 0: // 0 degrees
-        st7735_write_data(ST7735_MADCTL_MX | ST7735_MADCTL_MY | _color_mode);
-        _width = ST7735_TFTWIDTH;
-        _height = ST7735_TFTHEIGHT;
-        break;
-    case 1: // 90 degrees
-        st7735_write_data(ST7735_MADCTL_MY | ST7735_MADCTL_MV | _color_mode);
+        int row_bytes = (sprite->width + 7) / 8;
+        const uint8_t *src = (const uint8_t *)sprite->data + (frame * sprite->height + sy) * row_bytes;
+        uint16_t color = st7735_fb_color(sprite->color);
+        for (int j = 0; j < h; j++, src += row_bytes, dst += stride)
+        {
+            for (int i = 0; i < w; i++)
+            {
+                int c = sx + i;
+                if (src[c >> 3] & (0x80 >> (c & 7)))
+                {
+                    dst[i] = color;
+                }
+                else if (opaque)
+                {
+                    dst[i] = bg_color;
+                }
+            }
+        }
+        return;
+    }
+
+    const uint16_t *src = (const uint16_t *)sprite->data + (frame * sprite->height + sy) * sprite->width + sx;
+    for (int j = 0; j < h; j++, src += sprite->width, dst += stride)
+    {
+        for (int i = 0; i < w; i++)
+        {
+            if (src[i] != sprite->transparent)
+            {
+                dst[i] = st7735_fb_color(src[i]);
+            }
+            else if (opaque)
+            {
+                dst[i] = bg_color;
+            }
+        }
+    }
+}
+
+void st7735_draw_sprite(int x, int y, const st7735_sprite_t *sprite, int frame)
+{
+    st7735_draw_sprite_tagged(x, y, sprite, frame, 0);
+}
+
+void st7735_draw_sprite_tagged(int x, int y, const st7735_sprite_t *sprite, int frame, uint32_t tag)
+{
+    int w = sprite->width;
+    int h = sprite->height;
+    int sprite_x = x, sprite_y = y;
+    if (!st7735_clip_rect(&x, &y, &w, &h))
+    {
+        return;
+    }
+    frame %= sprite->frames;
+    int sx = x - sprite_x, sy = y - sprite_y;
+
+    if (_strip_enabled)
+    {
+        st7735_cmd_t *cmd = st7735_strip_cmd(ST7735_CMD_SPRITE, x, y, w, h, sx, sy);
+        if (cmd)
+        {
+            cmd->frame = frame;
+            cmd->src = sprite;
+            cmd->tag = tag;
+        }
+        return;
+    }
+    if (_fb_enabled)
+    {
+        st7735_fb_acquire();
+        st7735_blit_sprite(&_fb[y * _width + x], _width, sprite, frame, sx, sy, w, h, false, 0);
+        st7735_mark_dirty(x, y, w, h, tag ? tag | 0x80000000u : st7735_sprite_tag(sprite, frame));
+        return;
+    }
+
+    // Without a framebuffer the panel cannot be read back: transparent
+    // pixels become black, in bands that fit the blit buffer
+    int band = ST7735_BLIT_PIXELS / w;
+    for (int j = 0; j < h; j += band)
+    {
+        int rows = (h - j < band) ? h - j : band;
+        st7735_blit_sprite(_blit_buffer, w, sprite, frame, sx, sy + j, w, rows, true, 0);
+        st7735_begin_write(x, y + j, x + w - 1, y + j + rows - 1);
+        st7735_write_pixels((const uint8_t *)_blit_buffer, w * rows * 2);
+        st7735_end_write();
+    }
+}
+
+// Cells of the dirty grid used for batched points
+#define ST7735_POINT_CELL_SHIFT 4
+#define ST7735_POINT_CELLS_X ((ST7735_STRIP_WIDTH >> ST7735_POINT_CELL_SHIFT) + 1)
+#define ST7735_POINT_CELLS (ST7735_POINT_CELLS_X * ST7735_POINT_CELLS_X)
+
+void st7735_draw_points(const st7735_point_t *points, int count)
+{
+    if (_strip_enabled)
+    {
+        // One command over the bounding box; the strips pick their points
+        int x0 = _width, y0 = _height, x1 = -1, y1 = -1;
+        for (int i = 0; i < count; i++)
+        {
+            int x = points[i].x, y = points[i].y;
+            if (x < _width && y < _height)
+            {
+                x0 = x < x0 ? x : x0;
+                x1 = x > x1 ? x : x1;
+                y0 = y < y0 ? y : y0;
+                y1 = y > y1 ? y : y1;
+            }
+        }
+        if (x1 < 0)
+        {
+            return;
+        }
+        st7735_cmd_t *cmd = st7735_strip_cmd(ST7735_CMD_POINTS, x0, y0, x1 - x0 + 1, y1 - y0 + 1, 0, 0);
+        if (cmd)
+        {
+            cmd->stride = count;
+            cmd->src = points;
+        }
+        return;
+    }
+    if (_fb_enabled)
+    {
+        // Per 16x16 cell the box around its points becomes one dirty rect,
+        // so a cloud costs at most one rect per cell and stays tight
+        static uint8_t box[ST7735_POINT_CELLS][4]; // x0, y0, x1 + 1, y1 + 1; x1 + 1 == 0: empty
+        static uint16_t used[ST7735_POINT_CELLS];
+        int used_count = 0;
+        st7735_fb_acquire();
+        for (int i = 0; i < count; i++)
+        {
+            int x = points[i].x, y = points[i].y;
+            if (x >= _width || y >= _height)
+            {
+                continue;
+            }
+            _fb[y * _width + x] = st7735_fb_color(points[i].color);
+            int cell = (y >> ST7735_POINT_CELL_SHIFT) * ST7735_POINT_CELLS_X + (x >> ST7735_POINT_CELL_SHIFT);
+            uint8_t *b = box[cell];
+            if (b[2] == 0)
+            {
+                b[0] = x;
+                b[1] = y;
+                b[2] = x + 1;
+                b[3] = y + 1;
+                used[used_count++] = cell;
+                continue;
+            }
+            b[0] = x < b[0] ? x : b[0];
+            b[1] = y < b[1] ? y : b[1];
+            b[2] = x >= b[2] ? x + 1 : b[2];
+            b[3] = y >= b[3] ? y + 1 : b[3];
+        }
+        for (int i = 0; i < used_count; i++)
+        {
+            uint8_t *b = box[used[i]];
+            st7735_mark_dirty(b[0], b[1], b[2] - b[0], b[3] - b[1], 0);
+            b[2] = 0;
+        }
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        st7735_draw_pixel(points[i].x, points[i].y, points[i].color);
+    }
+}
+
+void st7735_set_rotation(uint8_t m)
+{
+    st7735_write_cmd(ST7735_MADCTL);
+    uint8_t rotation = m % 4; // 0, 1, 2, 3
+
+    switch (rotation)
+    {
+    case 0: // 0 degrees
+        st7735_write_data(ST7735_MADCTL_MX | ST7735_MADCTL_MY | _color_mode);
+        _width = ST7735_TFTWIDTH;
+        _height = ST7735_TFTHEIGHT;
+        break;
+    case 1: // 90 degrees
+        st7735_write_data(ST7735_MADCTL_MY | ST7735_MADCTL_MV | _color_mode);
         _width = ST7735_TFTHEIGHT;
         _height = ST7735_TFTWIDTH;
         break;
@@ -469,9 +1235,599 @@ void st7735_set_rotation(uint8_t m)
         _height = ST7735_TFTWIDTH;
         break;
     }
+    _strip_hash_valid = false; // strips are cut differently now
 }
 
 uint16_t st7735_rgb(uint8_t r, uint8_t g, uint8_t b)
 {
     return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
-}
\ No newline at end of file
+}
+
+void st7735_set_framebuffer(bool enable)
+{
+    st7735_dma_wait();
+    _fb_enabled = enable && ST7735_FRAMEBUFFER;
+    if (_fb_enabled)
+    {
+        _strip_enabled = false;
+    }
+}
+
+bool st7735_framebuffer_enabled(void)
+{
+    return _fb_enabled;
+}
+
+void st7735_set_dirty_tracking(bool enable)
+{
+    _dirty_enabled = enable;
+    for (int i = 0; i < 2; i++)
+    {
+        _drawn_count[i] = 0;
+        _drawn_overflow[i] = false;
+    }
+    _shown_count = 0;
+    _shown_overflow = false;
+    _full_redraw = true;
+}
+
+void st7735_begin_frame(uint16_t bg_color)
+{
+    if (!_fb_enabled || !_dirty_enabled)
+    {
+        st7735_fill_screen(bg_color);
+        return;
+    }
+    if (_drawn_overflow[_back])
+    {
+        // The rectangles of this buffer were lost: clear all of it. Unlike
+        // fill_screen() this leaves the other buffer alone; what the panel
+        // shows is still described by _shown (or was a full redraw)
+        st7735_fb_acquire();
+        st7735_fb_fill(0, 0, _width, _height, bg_color);
+        _drawn_count[_back] = 0;
+        _drawn_overflow[_back] = false;
+        return;
+    }
+
+    // Only erase what was last drawn into this buffer; the rest is background already
+    st7735_fb_acquire();
+    for (int i = 0; i < _drawn_count[_back]; i++)
+    {
+        const st7735_rect_t *r = &_drawn[_back][i];
+        st7735_fb_fill(r->x, r->y, r->w, r->h, bg_color);
+    }
+    _drawn_count[_back] = 0;
+}
+
+// Starts streaming a region of a framebuffer to the panel.
+static void st7735_send_region(const uint16_t *fb, int x, int y, int w, int h)
+{
+    st7735_begin_write(x, y, x + w - 1, y + h - 1);
+
+    if (w == _width)
+    {
+        // Full rows are contiguous in RAM: one DMA transfer
+        _bytes_sent += w * h * 2;
+        st7735_dma_start(&fb[y * _width], w * h * 2, false);
+        return;
+    }
+
+    for (int j = 0; j < h; j++)
+    {
+        st7735_write_pixels((const uint8_t *)&fb[(y + j) * _width + x], w * 2);
+    }
+    st7735_end_write();
+}
+
+// Display list words pass through the byte-swapping data channel (which puts
+// framebuffer bytes in wire order), so they are stored pre-swapped.
+static inline void st7735_dl_word(uint32_t **words, uint32_t value)
+{
+    *(*words)++ = __builtin_bswap32(value);
+}
+
+// Appends the frames for one region to the display list. pixels holds full
+// screen rows starting at row pixels_y. Returns false if the list is full.
+static bool st7735_dl_add_region(const uint16_t *pixels, int pixels_y, int x, int y, int w, int h)
+{
+    // 32-bit DMA reads need an even start column and an even pixel count per
+    // run; widening the region only resends pixels that are already correct
+    int x_end = (x + w + 1) & ~1;
+    x &= ~1;
+    w = x_end - x;
+
+    bool full_rows = (w == _width); // contiguous in RAM
+    int runs = full_rows ? 1 : h;
+    if (_dl_word_count + ST7735_DL_SETUP_WORDS > ST7735_DL_MAX_WORDS ||
+        _dl_block_count + 1 + runs >= ST7735_DL_MAX_BLOCKS) // keep a slot for the terminator
+    {
+        return false;
+    }
+
+    uint32_t *start = &_dl_words[_dl_word_count];
+    uint32_t *words = start;
+    int x0 = x + _offset, x1 = x + w - 1 + _offset;
+    int y0 = y + _offset, y1 = y + h - 1 + _offset;
+    st7735_dl_word(&words, st7735_pio_header(0, 8));
+    st7735_dl_word(&words, (uint32_t)ST7735_CASET << 24);
+    st7735_dl_word(&words, st7735_pio_header(1, 32));
+    st7735_dl_word(&words, ((uint32_t)x0 << 16) | (uint32_t)x1);
+    st7735_dl_word(&words, st7735_pio_header(0, 8));
+    st7735_dl_word(&words, (uint32_t)ST7735_RASET << 24);
+    st7735_dl_word(&words, st7735_pio_header(1, 32));
+    st7735_dl_word(&words, ((uint32_t)y0 << 16) | (uint32_t)y1);
+    st7735_dl_word(&words, st7735_pio_header(0, 8));
+    st7735_dl_word(&words, (uint32_t)ST7735_RAMWR << 24);
+    st7735_dl_word(&words, st7735_pio_header(1, w * h * 16));
+    _dl_word_count += words - start;
+    _dl_blocks[_dl_block_count++] = (st7735_dl_block_t){words - start, start};
+
+    if (full_rows)
+    {
+        _dl_blocks[_dl_block_count++] = (st7735_dl_block_t){w * h / 2, &pixels[(y - pixels_y) * _width]};
+    }
+    else
+    {
+        for (int j = 0; j < h; j++)
+        {
+            _dl_blocks[_dl_block_count++] = (st7735_dl_block_t){w / 2, &pixels[(y - pixels_y + j) * _width + x]};
+        }
+    }
+    _bytes_sent += 11 + w * h * 2;
+    return true;
+}
+
+// Terminates the display list and starts the DMA chain on it. From here on
+// the list is sent without the CPU.
+static void st7735_dl_start(void)
+{
+    _dl_blocks[_dl_block_count++] = (st7735_dl_block_t){0, NULL};
+    _dma_active = true;
+    dma_channel_set_read_addr(_dl_ctrl_chan, _dl_blocks, true);
+}
+
+// Sends framebuffer regions as one display list through the PIO interface.
+static void st7735_pio_flush(const uint16_t *fb, const st7735_rect_t *regions, int count)
+{
+    st7735_dma_wait();
+    _dl_block_count = 0;
+    _dl_word_count = 0;
+
+    bool complete = count >= 0;
+    for (int i = 0; complete && i < count; i++)
+    {
+        complete = st7735_dl_add_region(fb, 0, regions[i].x, regions[i].y, regions[i].w, regions[i].h);
+    }
+    if (!complete)
+    {
+        _dl_block_count = 0;
+        _dl_word_count = 0;
+        st7735_dl_add_region(fb, 0, 0, 0, _width, _height);
+    }
+    st7735_dl_start();
+}
+
+// Sends the regions collected for a buffer (count -1 = the whole screen).
+static void st7735_flush(int buffer, const st7735_rect_t *regions, int count)
+{
+    const uint16_t *fb = _framebuffers[buffer];
+    if (_pio_enabled)
+    {
+        st7735_pio_flush(fb, regions, count);
+        return;
+    }
+    if (count < 0)
+    {
+        st7735_send_region(fb, 0, 0, _width, _height);
+        return;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        st7735_send_region(fb, regions[i].x, regions[i].y, regions[i].w, regions[i].h);
+    }
+}
+
+// Works out which regions of the back buffer differ from the panel and
+// makes the back buffer's rectangles the new panel state. Returns the
+// number of regions, or -1 if the whole screen has to be sent.
+static int st7735_collect_regions(st7735_rect_t *regions)
+{
+    const st7735_rect_t *drawn = _drawn[_back];
+    int drawn_count = _drawn_count[_back];
+    int count = 0;
+
+    if (!_dirty_enabled || _full_redraw || _shown_overflow)
+    {
+        count = -1;
+        _full_redraw = false;
+    }
+    else
+    {
+        // Candidate regions: this frame's rectangles plus the ones to be erased
+        // from the previous frame. Identical solid fills in both frames (e.g. an
+        // enemy formation that did not move) left the pixels unchanged and are
+        // dropped; anything drawn over them is dirty on its own.
+        static bool unchanged[ST7735_MAX_DIRTY_RECTS];
+
+        memset(unchanged, 0, sizeof(unchanged));
+        for (int i = 0; i < drawn_count; i++)
+        {
+            bool same = false;
+            if (drawn[i].tag != 0)
+            {
+                for (int j = 0; j < _shown_count; j++)
+                {
+                    if (!unchanged[j] && st7735_rect_equal(&drawn[i], &_shown[j]))
+                    {
+                        unchanged[j] = true;
+                        same = true;
+                        break;
+                    }
+                }
+            }
+            if (!same)
+            {
+                regions[count++] = drawn[i];
+            }
+        }
+        for (int j = 0; j < _shown_count; j++)
+        {
+            if (!unchanged[j])
+            {
+                regions[count++] = _shown[j];
+            }
+        }
+
+        // Merge overlapping or touching regions until none are left
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (int i = 0; i < count; i++)
+            {
+                for (int j = i + 1; j < count; j++)
+                {
+                    if (st7735_rect_adjacent(&regions[i], &regions[j]))
+                    {
+                        st7735_rect_union(&regions[i], &regions[j]);
+                        regions[j] = regions[--count];
+                        merged = true;
+                        j = i;
+                    }
+                }
+            }
+        }
+    }
+
+    memcpy(_shown, drawn, drawn_count * sizeof(st7735_rect_t));
+    _shown_count = drawn_count;
+    _shown_overflow = _drawn_overflow[_back];
+    return count;
+}
+
+// Core 1 loop in pipelined mode: sends each buffer queued by present().
+static void st7735_core1_entry(void)
+{
+    while (true)
+    {
+        int buffer = (int)multicore_fifo_pop_blocking();
+        __dmb();
+        st7735_flush(buffer, _job_regions[buffer], _job_count[buffer]);
+        st7735_dma_wait();
+        __dmb();
+        _frames_flushed++;
+    }
+}
+
+// Starts sending a rasterized strip (full rows y to y + h - 1).
+static void st7735_send_strip(const uint16_t *strip, int y, int h)
+{
+    if (_pio_enabled)
+    {
+        st7735_dma_wait();
+        _dl_block_count = 0;
+        _dl_word_count = 0;
+        st7735_dl_add_region(strip, y, 0, y, _width, h);
+        st7735_dl_start();
+        return;
+    }
+    st7735_begin_write(0, y, _width - 1, y + h - 1);
+    _bytes_sent += _width * h * 2;
+    st7735_dma_start(strip, _width * h * 2, false);
+}
+
+static inline uint32_t st7735_hash(uint32_t hash, uint32_t value)
+{
+    return (hash ^ value) * 16777619u; // FNV-1a step
+}
+
+// Hash of everything that ends up in the strip at row y0 (lines rows).
+static uint32_t st7735_strip_hash(int y0, int lines)
+{
+    uint32_t hash = st7735_hash(2166136261u, _strip_bg);
+    for (int i = 0; i < _cmd_count; i++)
+    {
+        const st7735_cmd_t *cmd = &_cmds[i];
+        if (cmd->y >= y0 + lines || cmd->y + cmd->h <= y0)
+        {
+            continue;
+        }
+        hash = st7735_hash(hash, ((uint32_t)(uint16_t)cmd->x << 16) | (uint16_t)cmd->y);
+        hash = st7735_hash(hash, ((uint32_t)(uint16_t)cmd->w << 16) | (uint16_t)cmd->h);
+        hash = st7735_hash(hash, ((uint32_t)(uint16_t)cmd->sx << 16) | (uint16_t)cmd->sy);
+        hash = st7735_hash(hash, ((uint32_t)cmd->type << 24) | ((uint32_t)cmd->frame << 16) | cmd->stride);
+        hash = st7735_hash(hash, ((uint32_t)cmd->color << 16) | cmd->bg_color);
+        if (cmd->type == ST7735_CMD_TEXT)
+        {
+            for (const char *c = cmd->src; *c; c++)
+            {
+                hash = st7735_hash(hash, (uint8_t)*c);
+            }
+        }
+        else
+        {
+            hash = st7735_hash(hash, cmd->tag ? cmd->tag : (uint32_t)(uintptr_t)cmd->src);
+        }
+        if (cmd->type == ST7735_CMD_BUFFER || cmd->type == ST7735_CMD_POINTS)
+        {
+            hash = st7735_hash(hash, _strip_frame);
+        }
+    }
+    return hash;
+}
+
+// Rasterizes the command list into the strip at row y0.
+static void st7735_strip_render(uint16_t *strip, int y0, int lines)
+{
+    st7735_fill_pixels(strip, _width, _width, lines, _strip_bg);
+    for (int i = 0; i < _cmd_count; i++)
+    {
+        const st7735_cmd_t *cmd = &_cmds[i];
+        int top = cmd->y > y0 ? cmd->y : y0;
+        int bottom = (cmd->y + cmd->h) < (y0 + lines) ? (cmd->y + cmd->h) : (y0 + lines);
+        if (top >= bottom)
+        {
+            continue;
+        }
+
+        uint16_t *dst = &strip[(top - y0) * _width + cmd->x];
+        int rows = bottom - top;
+        int src_row = cmd->sy + (top - cmd->y);
+        switch (cmd->type)
+        {
+        case ST7735_CMD_FILL:
+            st7735_fill_pixels(dst, _width, cmd->w, rows, cmd->color);
+            break;
+        case ST7735_CMD_TEXT:
+            st7735_render_text(dst, _width, cmd->src, cmd->sx, cmd->w, src_row, rows, cmd->color,
+                               cmd->bg_color);
+            break;
+        case ST7735_CMD_SPRITE:
+            st7735_blit_sprite(dst, _width, cmd->src, cmd->frame, cmd->sx, src_row, cmd->w, rows, false, 0);
+            break;
+        case ST7735_CMD_BUFFER:
+        {
+            const uint16_t *src = (const uint16_t *)cmd->src + src_row * cmd->stride + cmd->sx;
+            for (int j = 0; j < rows; j++)
+            {
+                memcpy(&dst[j * _width], &src[j * cmd->stride], cmd->w * 2);
+            }
+            break;
+        }
+        case ST7735_CMD_POINTS:
+        {
+            const st7735_point_t *p = cmd->src;
+            for (int k = 0; k < cmd->stride; k++)
+            {
+                if (p[k].y >= top && p[k].y < bottom && p[k].x < _width)
+                {
+                    strip[(p[k].y - y0) * _width + p[k].x] = st7735_fb_color(p[k].color);
+                }
+            }
+            break;
+        }
+        }
+    }
+}
+
+static void st7735_strip_present(void)
+{
+    int strip_index = 0;
+    for (int y0 = 0; y0 < _height; y0 += ST7735_STRIP_LINES, strip_index++)
+    {
+        int lines = (_height - y0) < ST7735_STRIP_LINES ? (_height - y0) : ST7735_STRIP_LINES;
+        uint32_t hash = st7735_strip_hash(y0, lines);
+        if (_strip_hash_valid && _strip_hash[strip_index] == hash)
+        {
+            continue;
+        }
+        _strip_hash[strip_index] = hash;
+
+        // The other buffer may still be on the bus; this one is free
+        uint16_t *strip = _strips[_strip_buf];
+        _strip_buf ^= 1;
+        st7735_strip_render(strip, y0, lines);
+        st7735_send_strip(strip, y0, lines);
+    }
+    _strip_hash_valid = true;
+    _strip_frame++;
+}
+
+void st7735_set_strip_mode(bool enable)
+{
+    if (enable)
+    {
+        st7735_set_pipelined(false);
+        st7735_set_framebuffer(false);
+        _cmd_count = 0;
+        _text_used = 0;
+        _strip_bg = 0;
+        _strip_hash_valid = false; // the panel content is unknown
+    }
+    st7735_dma_wait();
+    _strip_enabled = enable;
+}
+
+void st7735_present(void)
+{
+    if (_strip_enabled)
+    {
+        st7735_strip_present();
+        return;
+    }
+    if (!_fb_enabled)
+    {
+        return;
+    }
+
+    if (!_pipelined)
+    {
+        int count = st7735_collect_regions(_job_regions[0]);
+        st7735_flush(_back, _job_regions[0], count);
+        return;
+    }
+
+    // The buffer drawn next is the one core 1 may still be sending
+    st7735_pipeline_wait();
+    _job_count[_back] = st7735_collect_regions(_job_regions[_back]);
+    __dmb();
+    _frames_queued++;
+    multicore_fifo_push_blocking(_back);
+
+    _back ^= 1;
+    _fb = _framebuffers[_back];
+}
+
+void st7735_set_pipelined(bool enable)
+{
+    if (!_fb_enabled || enable == _pipelined)
+    {
+        return;
+    }
+
+    st7735_dma_wait();
+    if (enable && !_core1_launched)
+    {
+        multicore_launch_core1(st7735_core1_entry);
+        _core1_launched = true;
+    }
+    _pipelined = enable;
+
+    // The other buffer has stale content; clear it fully before it is used
+    _drawn_overflow[_back ^ 1] = true;
+    _full_redraw = true;
+}
+
+void st7735_get_pipeline_stats(st7735_pipeline_stats_t *stats)
+{
+    stats->frames_presented = _frames_queued;
+    stats->frames_stalled = _frames_stalled;
+    stats->stall_us = _stall_us;
+}
+
+bool st7735_use_pio(PIO pio, uint sck_pin, uint mosi_pin)
+{
+    if (sck_pin != _ce_pin + 1)
+    {
+        // CS and SCK share the side-set pins, so they must be neighbours
+        return false;
+    }
+
+    st7735_dma_wait();
+    if (_pio_offset < 0)
+    {
+        _pio = pio;
+        _pio_offset = pio_add_program(pio, &st7735_lcd_program);
+        _pio_sm = pio_claim_unused_sm(pio, true);
+        _dl_data_chan = dma_claim_unused_channel(true);
+        _dl_ctrl_chan = dma_claim_unused_channel(true);
+
+        // Data channel: display list words -> PIO TX FIFO, then back to the control channel
+        dma_channel_config c = dma_channel_get_default_config(_dl_data_chan);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, pio_get_dreq(_pio, _pio_sm, true));
+        channel_config_set_chain_to(&c, _dl_ctrl_chan);
+        channel_config_set_bswap(&c, true);
+        channel_config_set_irq_quiet(&c, true);
+        dma_channel_configure(_dl_data_chan, &c, &_pio->txf[_pio_sm], NULL, 0, false);
+
+        // Control channel: copies {count, addr} into the data channel and triggers it
+        c = dma_channel_get_default_config(_dl_ctrl_chan);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_ring(&c, true, 3); // wrap the writes over the two registers
+        dma_channel_configure(_dl_ctrl_chan, &c, &dma_channel_hw_addr(_dl_data_chan)->al3_transfer_count,
+                              _dl_blocks, 2, false);
+    }
+
+    st7735_lcd_program_init(_pio, _pio_sm, _pio_offset, _ce_pin, _dc_pin, mosi_pin,
+                            (float)spi_get_baudrate(_spi));
+    _pio_sck_pin = sck_pin;
+    _pio_mosi_pin = mosi_pin;
+    _pio_enabled = true;
+    return true;
+}
+
+void st7735_release_pio(void)
+{
+    if (_pio_offset < 0)
+    {
+        return;
+    }
+
+    st7735_dma_wait();
+    pio_sm_set_enabled(_pio, _pio_sm, false);
+    pio_sm_unclaim(_pio, _pio_sm);
+    pio_remove_program(_pio, &st7735_lcd_program, _pio_offset);
+    dma_channel_unclaim(_dl_data_chan);
+    dma_channel_unclaim(_dl_ctrl_chan);
+    _pio_sm = -1;
+    _pio_offset = -1;
+    _dl_data_chan = -1;
+    _dl_ctrl_chan = -1;
+    _pio_enabled = false;
+
+    // SCK and MOSI back to the SPI block, CS and D/C to software control
+    gpio_set_function(_pio_sck_pin, GPIO_FUNC_SPI);
+    gpio_set_function(_pio_mosi_pin, GPIO_FUNC_SPI);
+    gpio_init(_ce_pin);
+    gpio_init(_dc_pin);
+    gpio_set_dir(_ce_pin, GPIO_OUT);
+    gpio_set_dir(_dc_pin, GPIO_OUT);
+    gpio_put(_ce_pin, 1);
+    gpio_put(_dc_pin, 1);
+}
+
+bool st7735_is_busy(void)
+{
+    if (_pipelined && _frames_flushed != _frames_queued)
+    {
+        return true;
+    }
+    if (_dma_active && get_core_num() == 0)
+    {
+        bool running = _pio_enabled ? !st7735_pio_idle()
+                                    : (dma_channel_is_busy(_dma_chan) || spi_is_busy(_spi));
+        if (running)
+        {
+            return true;
+        }
+        // Finished: release the bus right away
+        st7735_dma_wait();
+    }
+    return false;
+}
+
+void st7735_wait(void)
+{
+    st7735_dma_wait();
+}
+
+uint32_t st7735_get_bytes_sent(void)
+{
+    return _bytes_sent;
+}
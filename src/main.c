@@ -3,12 +3,24 @@
 #include "include/demos/Abgabe_09.h"
 #include "game/game.h"
 #include "game/handling.h"
+#include "demos/display_bench.h"
+#include "demos/fixed_bench.h"
+#include "demos/particle_bench.h"
 
 int main(void)
 {
     stdio_init_all();
     sleep_ms(2000); // Zeit für USB-Serial
 
+    // Benchmarks instead of the game, selected in CMakeLists.txt
+#if DISPLAY_BENCH
+    display_bench_execute();
+#elif FIXED_BENCH
+    fixed_bench_execute();
+#elif PARTICLE_BENCH
+    particle_bench_execute();
+#endif
+
     game_init();       // Display + Startmenü
     handling_execute(); // Game-Loop (läuft endlos)
 